@@ -0,0 +1,156 @@
+/// Monotonic arena allocator.
+///
+/// 'Arena' hands out memory from a caller-provided buffer by bumping an
+/// offset. Individual allocations are never freed. Instead the arena is
+/// rewound to a marker taken earlier, which releases everything allocated
+/// since in constant time. This suits scratch memory that lives for one
+/// control cycle, e.g. while building a packet.
+///
+/// Objects created in an arena are not destroyed when it is rewound, so
+/// only trivially destructible types are accepted. The arena records the
+/// highest offset ever reached, so the buffer can be sized from
+/// measurements.
+///
+/// An arena is not synchronized and must be used from one context only.
+///
+/// # Examples
+///
+/// ```
+/// __attribute__((section(".ram2"))) unsigned char scratch_buffer[4096];
+/// Arena scratch { scratch_buffer, sizeof(scratch_buffer) };
+///
+/// void control_cycle() {
+///     Arena::Scope scope { scratch };
+///     uint8_t* packet = scratch.try_make_array<uint8_t>(256).unwrap();
+///     ...
+/// }
+/// ```
+
+#ifndef CCL_ARENA_HPP
+#define CCL_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "capacity_error.hpp"
+#include "non_null.hpp"
+#include "result.hpp"
+#include "try.hpp"
+
+namespace ccl {
+
+class Arena {
+   public:
+    /// Position in the arena, see 'mark' and 'rewind'.
+    struct Marker {
+        std::size_t offset;
+    };
+
+    /// Rewinds the arena to the position at construction when it goes out
+    /// of scope.
+    class Scope {
+       public:
+        explicit Scope(Arena& arena)
+            : arena_ { arena }, marker_ { arena.mark() } {}
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+        ~Scope() {
+            arena_.rewind(marker_);
+        }
+
+       private:
+        Arena& arena_;
+        Marker marker_;
+    };
+
+    Arena(void* buffer, std::size_t size)
+        : buffer_ { static_cast<unsigned char*>(buffer) }, size_ { size } {}
+
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+    ~Arena() = default;
+
+    /// Allocates 'size' bytes aligned to 'alignment', which must be a power
+    /// of two.
+    Result<void*, CapacityError> try_allocate(
+        std::size_t size,
+        std::size_t alignment = alignof(std::max_align_t)
+    );
+
+    template <typename T, typename... Args>
+    Result<NonNull<T>, CapacityError> try_make(Args&&... args) {
+        static_assert(
+            std::is_trivially_destructible_v<T>,
+            "Arena never destroys its objects"
+        );
+        void* memory = CCL_TRY(try_allocate(sizeof(T), alignof(T)));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        return Ok { NonNull<T> { *object } };
+    }
+
+    /// Allocates 'count' value-initialized elements.
+    template <typename T>
+    Result<T*, CapacityError> try_make_array(std::size_t count) {
+        static_assert(
+            std::is_trivially_destructible_v<T>,
+            "Arena never destroys its objects"
+        );
+        if (count > size_ / sizeof(T)) {
+            return Err { CapacityError::Full };
+        }
+        void* memory = CCL_TRY(try_allocate(count * sizeof(T), alignof(T)));
+        auto* first = static_cast<T*>(memory);
+        for (std::size_t i = 0; i < count; ++i) {
+            new (first + i) T {};
+        }
+        return Ok { first };
+    }
+
+    Marker mark() const {
+        return Marker { offset_ };
+    }
+
+    /// Releases everything allocated after 'marker' was taken.
+    void rewind(Marker marker) {
+        offset_ = marker.offset;
+    }
+
+    void reset() {
+        offset_ = 0;
+    }
+
+    std::size_t used() const {
+        return offset_;
+    }
+
+    /// Highest number of bytes ever in use, including alignment padding.
+    std::size_t high_water() const {
+        return high_water_;
+    }
+
+    std::size_t capacity() const {
+        return size_;
+    }
+
+   private:
+    unsigned char* buffer_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+    std::size_t high_water_ = 0;
+};
+
+namespace prelude {
+using ccl::Arena;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,57 @@
+/// 'std::pmr' adaptor for 'Arena'.
+///
+/// 'ArenaResource' lets standard containers allocate from an arena, which
+/// is mostly useful for host tests of code that takes
+/// a 'std::pmr::memory_resource'. Deallocation does nothing, memory is
+/// released by rewinding the arena. Exhaustion panics since the firmware
+/// does not use exceptions.
+///
+/// # Examples
+///
+/// ```
+/// Arena arena { buffer, sizeof(buffer) };
+/// ArenaResource resource { arena };
+/// std::pmr::vector<int> values { &resource };
+/// ```
+
+#ifndef CCL_ARENA_RESOURCE_HPP
+#define CCL_ARENA_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "arena.hpp"
+
+namespace ccl {
+
+class ArenaResource : public std::pmr::memory_resource {
+   public:
+    explicit ArenaResource(Arena& arena) : arena_ { arena } {}
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return arena_.try_allocate(bytes, alignment)
+            .expect("Arena exhausted");
+    }
+
+    void do_deallocate(
+        void* /*p*/,
+        std::size_t /*bytes*/,
+        std::size_t /*alignment*/
+    ) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other
+    ) const noexcept override {
+        return this == &other;
+    }
+
+    Arena& arena_;
+};
+
+namespace prelude {
+using ccl::ArenaResource;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,28 @@
+/// Error returned when an access falls outside a buffer.
+///
+/// 'BoundsError' has a niche, so 'Result<Unit, BoundsError>' is a single
+/// byte.
+
+#ifndef CCL_BOUNDS_ERROR_HPP
+#define CCL_BOUNDS_ERROR_HPP
+
+#include <cstdint>
+
+#include "niche.hpp"
+
+namespace ccl {
+
+enum class BoundsError : uint8_t { OutOfBounds = 1 };
+
+template <>
+struct Niche<BoundsError> {
+    static constexpr BoundsError value = BoundsError { 0 };
+};
+
+namespace prelude {
+using ccl::BoundsError;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,240 @@
+/// Endian-aware access to byte buffers.
+///
+/// 'ByteReader' and 'ByteWriter' read and write integers, enums and floats
+/// in little- or big-endian byte order at any offset of a byte span,
+/// regardless of alignment. Values are copied with 'memcpy' and swapped
+/// with '__builtin_bswap', which GCC lowers to a single LDR or STR followed
+/// or preceded by REV on Cortex-M4, which allows unaligned word access.
+///
+/// Both types offer random access at an offset and sequential access at
+/// a position that advances. Accesses that would leave the buffer fail
+/// with 'BoundsError::OutOfBounds' and have no effect.
+///
+/// # Examples
+///
+/// ```
+/// ByteReader reader { frame };
+/// const uint16_t id = CCL_TRY(reader.read<uint16_t, Endian::Big>());
+/// const float value = CCL_TRY(reader.read<float>());
+///
+/// ByteWriter writer { reply };
+/// CCL_TRY(writer.write<uint16_t, Endian::Big>(id));
+/// ```
+
+#ifndef CCL_BYTE_IO_HPP
+#define CCL_BYTE_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "bounds_error.hpp"
+#include "result.hpp"
+#include "span.hpp"
+#include "try.hpp"
+
+namespace ccl {
+
+enum class Endian : uint8_t { Little, Big };
+
+namespace detail {
+
+template <std::size_t Size>
+struct unsigned_of_size;
+
+template <>
+struct unsigned_of_size<1> {
+    using type = uint8_t;
+};
+
+template <>
+struct unsigned_of_size<2> {
+    using type = uint16_t;
+};
+
+template <>
+struct unsigned_of_size<4> {
+    using type = uint32_t;
+};
+
+template <>
+struct unsigned_of_size<8> {
+    using type = uint64_t;
+};
+
+template <typename T>
+inline constexpr bool is_byte_io_type = std::is_arithmetic_v<T>
+                                        || std::is_enum_v<T>;
+
+template <typename U>
+constexpr U byte_swap(U value) {
+    if constexpr (sizeof(U) == 1) {
+        return value;
+    } else if constexpr (sizeof(U) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(U) == 4) {
+        return __builtin_bswap32(value);
+    } else {
+        return __builtin_bswap64(value);
+    }
+}
+
+template <typename U, Endian Order>
+constexpr U to_native(U value) {
+    constexpr bool native_little =
+        __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+    return (Order == Endian::Little) == native_little ? value
+                                                      : byte_swap(value);
+}
+
+}  // namespace detail
+
+/// Reads a value from 'bytes' without bounds checking.
+template <typename T, Endian Order = Endian::Little>
+T load(const uint8_t* bytes) {
+    static_assert(detail::is_byte_io_type<T>, "T must be arithmetic or enum");
+    using U = typename detail::unsigned_of_size<sizeof(T)>::type;
+    U raw;
+    std::memcpy(&raw, bytes, sizeof(U));
+    raw = detail::to_native<U, Order>(raw);
+    T value;
+    std::memcpy(&value, &raw, sizeof(T));
+    return value;
+}
+
+/// Writes a value to 'bytes' without bounds checking.
+template <typename T, Endian Order = Endian::Little>
+void store(uint8_t* bytes, T value) {
+    static_assert(detail::is_byte_io_type<T>, "T must be arithmetic or enum");
+    using U = typename detail::unsigned_of_size<sizeof(T)>::type;
+    U raw;
+    std::memcpy(&raw, &value, sizeof(U));
+    raw = detail::to_native<U, Order>(raw);
+    std::memcpy(bytes, &raw, sizeof(U));
+}
+
+class ByteReader {
+   public:
+    explicit ByteReader(Span<const uint8_t> bytes) : bytes_ { bytes } {}
+
+    template <typename T, Endian Order = Endian::Little>
+    Result<T, BoundsError> read_at(std::size_t offset) const {
+        if (!fits(offset, sizeof(T))) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        return Ok { load<T, Order>(bytes_.data() + offset) };
+    }
+
+    /// Reads at the current position and advances past the value.
+    template <typename T, Endian Order = Endian::Little>
+    Result<T, BoundsError> read() {
+        const T value = CCL_TRY((read_at<T, Order>(position_)));
+        position_ += sizeof(T);
+        return Ok { value };
+    }
+
+    /// Returns the next 'count' bytes and advances past them.
+    Result<Span<const uint8_t>, BoundsError> read_bytes(std::size_t count) {
+        if (!fits(position_, count)) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        const Span<const uint8_t> bytes = bytes_.subspan(position_, count);
+        position_ += count;
+        return Ok { bytes };
+    }
+
+    Result<Unit, BoundsError> skip(std::size_t count) {
+        if (!fits(position_, count)) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        position_ += count;
+        return Ok { Unit {} };
+    }
+
+    std::size_t position() const {
+        return position_;
+    }
+
+    std::size_t remaining() const {
+        return bytes_.size() - position_;
+    }
+
+    Span<const uint8_t> bytes() const {
+        return bytes_;
+    }
+
+   private:
+    bool fits(std::size_t offset, std::size_t size) const {
+        return offset <= bytes_.size() && size <= bytes_.size() - offset;
+    }
+
+    Span<const uint8_t> bytes_;
+    std::size_t position_ = 0;
+};
+
+class ByteWriter {
+   public:
+    explicit ByteWriter(Span<uint8_t> bytes) : bytes_ { bytes } {}
+
+    template <typename T, Endian Order = Endian::Little>
+    Result<Unit, BoundsError> write_at(std::size_t offset, T value) {
+        if (!fits(offset, sizeof(T))) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        store<T, Order>(bytes_.data() + offset, value);
+        return Ok { Unit {} };
+    }
+
+    /// Writes at the current position and advances past the value.
+    template <typename T, Endian Order = Endian::Little>
+    Result<Unit, BoundsError> write(T value) {
+        CCL_TRY((write_at<T, Order>(position_, value)));
+        position_ += sizeof(T);
+        return Ok { Unit {} };
+    }
+
+    Result<Unit, BoundsError> write_bytes(Span<const uint8_t> bytes) {
+        if (!fits(position_, bytes.size())) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        if (!bytes.empty()) {
+            std::memcpy(bytes_.data() + position_, bytes.data(), bytes.size());
+        }
+        position_ += bytes.size();
+        return Ok { Unit {} };
+    }
+
+    std::size_t position() const {
+        return position_;
+    }
+
+    std::size_t remaining() const {
+        return bytes_.size() - position_;
+    }
+
+    /// The bytes written so far.
+    Span<uint8_t> written() const {
+        return bytes_.first(position_);
+    }
+
+   private:
+    bool fits(std::size_t offset, std::size_t size) const {
+        return offset <= bytes_.size() && size <= bytes_.size() - offset;
+    }
+
+    Span<uint8_t> bytes_;
+    std::size_t position_ = 0;
+};
+
+namespace prelude {
+
+using ccl::ByteReader;
+using ccl::ByteWriter;
+using ccl::Endian;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,107 @@
+/// Table of callbacks bound to handles.
+///
+/// C libraries such as the STM32 HAL report completions through global
+/// functions that receive a handle. 'CallbackTable<Handle, Signature, N>'
+/// routes such a call to the callbacks that driver objects bound to the
+/// handle, without globals per driver and without allocating.
+///
+/// Several callbacks may be bound to the same handle, e.g. the receiver and
+/// the transmitter of one UART both want its error callback. They are
+/// called in binding order. Lookup is a linear search over at most 'N'
+/// entries.
+///
+/// Binding is not synchronized with dispatching. Callbacks should be bound
+/// before the interrupts that dispatch them are enabled.
+///
+/// # Examples
+///
+/// ```
+/// CallbackTable<UART_HandleTypeDef, void(), 4> uart_tx_complete;
+///
+/// uart_tx_complete.try_bind(&huart2, [this] { on_tx_complete(); })
+///     .expect("Too many UART callbacks");
+///
+/// extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+///     uart_tx_complete.dispatch(huart);
+/// }
+/// ```
+
+#ifndef CCL_CALLBACK_TABLE_HPP
+#define CCL_CALLBACK_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "capacity_error.hpp"
+#include "inplace_function.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+template <typename Handle, typename Signature, std::size_t N>
+class CallbackTable;
+
+template <typename Handle, typename... Args, std::size_t N>
+class CallbackTable<Handle, void(Args...), N> {
+   public:
+    using Callback = InplaceFunction<void(Args...)>;
+
+    Result<Unit, CapacityError> try_bind(Handle* handle, Callback callback) {
+        if (size_ == N) {
+            return Err { CapacityError::Full };
+        }
+        entries_[size_++] = Entry { handle, callback };
+        return Ok { Unit {} };
+    }
+
+    /// Removes all callbacks bound to 'handle'.
+    void unbind(const Handle* handle) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (entries_[i].handle != handle) {
+                entries_[kept++] = entries_[i];
+            }
+        }
+        size_ = kept;
+    }
+
+    bool is_bound(const Handle* handle) const {
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (entries_[i].handle == handle) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Calls every callback bound to 'handle'. Returns false if there is
+    /// none.
+    bool dispatch(const Handle* handle, Args... args) const {
+        bool found = false;
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (entries_[i].handle == handle) {
+                entries_[i].callback(args...);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+   private:
+    struct Entry {
+        const Handle* handle;
+        Callback callback;
+    };
+
+    std::array<Entry, N> entries_ {};
+    std::size_t size_ = 0;
+};
+
+namespace prelude {
+using ccl::CallbackTable;
+}
+
+}  // namespace ccl
+
+#endif
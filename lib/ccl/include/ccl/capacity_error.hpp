@@ -0,0 +1,28 @@
+/// Error returned by fixed-capacity containers when they are full.
+///
+/// 'CapacityError' has a niche, so 'Result<Unit, CapacityError>' is a single
+/// byte.
+
+#ifndef CCL_CAPACITY_ERROR_HPP
+#define CCL_CAPACITY_ERROR_HPP
+
+#include <cstdint>
+
+#include "niche.hpp"
+
+namespace ccl {
+
+enum class CapacityError : uint8_t { Full = 1 };
+
+template <>
+struct Niche<CapacityError> {
+    static constexpr CapacityError value = CapacityError { 0 };
+};
+
+namespace prelude {
+using ccl::CapacityError;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,110 @@
+/// Consistent Overhead Byte Stuffing.
+///
+/// COBS removes all zero bytes from a packet at the cost of one byte per
+/// 254 bytes of payload, so a zero byte can delimit packets on a byte
+/// stream such as a UART. A receiver resynchronizes on the next zero after
+/// a corrupted or truncated packet.
+///
+/// 'CobsWriter' encodes a packet into a caller-provided buffer while it is
+/// written, piece by piece, so the packet does not have to be assembled
+/// first. 'finish' appends the zero delimiter. Writes that do not fit make
+/// 'finish' fail with 'BoundsError::OutOfBounds'.
+///
+/// # Examples
+///
+/// ```
+/// std::array<uint8_t, max_cobs_size(64) + 1> packet;
+/// CobsWriter writer { packet };
+/// writer.write(channel);
+/// writer.write(payload);
+/// const Span<uint8_t> encoded = CCL_TRY(writer.finish());
+/// ```
+
+#ifndef CCL_COBS_HPP
+#define CCL_COBS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bounds_error.hpp"
+#include "result.hpp"
+#include "span.hpp"
+
+namespace ccl {
+
+/// Largest encoded size of 'size' bytes, without the delimiter.
+constexpr std::size_t max_cobs_size(std::size_t size) {
+    return size + size / 254 + 1;
+}
+
+class CobsWriter {
+   public:
+    explicit CobsWriter(Span<uint8_t> out) : out_ { out } {}
+
+    void write(uint8_t byte) {
+        if (byte == 0) {
+            close_block();
+            return;
+        }
+        if (!fits(1)) {
+            return;
+        }
+        out_[position_++] = byte;
+        if (++code_ == 0xFF) {
+            close_block();
+        }
+    }
+
+    void write(Span<const uint8_t> bytes) {
+        for (const uint8_t byte : bytes) {
+            write(byte);
+        }
+    }
+
+    /// Terminates the packet and returns the encoded bytes including the
+    /// delimiter.
+    Result<Span<uint8_t>, BoundsError> finish() {
+        if (!fits(1)) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        out_[code_index_] = code_;
+        out_[position_++] = 0;
+        return Ok { out_.first(position_) };
+    }
+
+   private:
+    bool fits(std::size_t size) {
+        if (overflow_ || out_.size() < position_ + size) {
+            overflow_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void close_block() {
+        if (!fits(1)) {
+            return;
+        }
+        out_[code_index_] = code_;
+        code_index_ = position_++;
+        code_ = 1;
+    }
+
+    Span<uint8_t> out_;
+    // The first code byte is reserved at offset 0.
+    std::size_t code_index_ = 0;
+    std::size_t position_ = 1;
+    uint8_t code_ = 1;
+    bool overflow_ = false;
+};
+
+namespace prelude {
+
+using ccl::CobsWriter;
+using ccl::max_cobs_size;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
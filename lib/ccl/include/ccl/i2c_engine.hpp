@@ -0,0 +1,325 @@
+/// Batched asynchronous I2C transactions.
+///
+/// 'I2cEngine<Bus, Clock, Lock>' runs batches of register reads and writes
+/// for any number of devices back to back. A batch is a span of
+/// 'I2cTransfer's and a completion callback. The engine starts the next
+/// transfer from the completion interrupt of the previous one, so the bus
+/// never waits for the main loop, and calls the batch's callback once all
+/// its transfers are done. Batches are queued intrusively in submission
+/// order, the engine never allocates.
+///
+/// A failed transfer is marked with 'I2cTransfer::Status::Error' and the
+/// batch continues with the next transfer, so one missing device does not
+/// hide the results of the others.
+///
+/// The engine measures, in 'Clock::cycles()', the bus time of each
+/// transfer, the latency of each batch from submission to completion and
+/// the total bus time, from which 'I2cStats' derives the bus utilization.
+/// The utilization is a share of the cycles counted by 'Clock': with a core
+/// cycle counter that stops in low-power modes it is the share of the
+/// active time, and cycles count less time at higher clock speeds.
+///
+/// 'Bus' drives the hardware, or a simulation on the host, and provides:
+/// * 'void bind(InplaceFunction<void(bool)> done)' - sets the function to
+///   call when a transfer completes or fails,
+/// * 'bool begin(const I2cTransfer& transfer)' - starts a transfer, returns
+///   false if it could not be started.
+///
+/// 'Clock' provides 'static uint32_t cycles()'. 'Lock' is a critical
+/// section with respect to the bus interrupts, see 'TimerWheel'.
+///
+/// Completion callbacks run in the bus interrupt, or in 'submit' if no
+/// transfer of the batch could be started. They may submit batches.
+/// Completions reported by the bus while no transfer is in progress, e.g.
+/// a late error interrupt, are ignored and counted.
+///
+/// # Examples
+///
+/// ```
+/// std::array<uint8_t, 6> accel {};
+/// std::array<uint8_t, 2> temperature {};
+/// I2cTransfer transfers[] = {
+///     I2cTransfer::read(0x6A, 0x28, accel),
+///     I2cTransfer::read(0x48, 0x00, temperature),
+/// };
+/// I2cBatch batch { transfers, [](I2cBatch& done) { events.try_push(...); } };
+///
+/// engine.submit(batch);
+/// ```
+
+#ifndef CCL_I2C_ENGINE_HPP
+#define CCL_I2C_ENGINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "inplace_function.hpp"
+#include "panic.hpp"
+#include "span.hpp"
+
+namespace ccl {
+
+/// One register access on one device.
+struct I2cTransfer {
+    enum class Direction : uint8_t { Read, Write };
+    enum class Status : uint8_t { Pending, Ok, Error };
+
+    static I2cTransfer read(uint8_t address, uint8_t reg, Span<uint8_t> data) {
+        return I2cTransfer { address, reg, Direction::Read, data };
+    }
+
+    static I2cTransfer write(uint8_t address, uint8_t reg, Span<uint8_t> data) {
+        return I2cTransfer { address, reg, Direction::Write, data };
+    }
+
+    /// 7-bit device address.
+    uint8_t address;
+    uint8_t reg;
+    Direction direction;
+    Span<uint8_t> data;
+
+    // Results, set by the engine.
+    Status status = Status::Pending;
+    /// Bus time from start to completion.
+    uint32_t cycles = 0;
+};
+
+template <typename Bus, typename Clock, typename Lock>
+class I2cEngine;
+
+class I2cBatch {
+   public:
+    using Callback = InplaceFunction<void(I2cBatch&)>;
+
+    I2cBatch(Span<I2cTransfer> transfers, Callback on_complete)
+        : transfers_ { transfers }, on_complete_ { on_complete } {}
+
+    I2cBatch(const I2cBatch&) = delete;
+    I2cBatch(I2cBatch&&) = delete;
+    I2cBatch& operator=(const I2cBatch&) = delete;
+    I2cBatch& operator=(I2cBatch&&) = delete;
+    ~I2cBatch() = default;
+
+    Span<I2cTransfer> transfers() const {
+        return transfers_;
+    }
+
+    /// True from submission until the completion callback is called.
+    bool is_pending() const {
+        return pending_;
+    }
+
+    /// True if all transfers succeeded, valid after completion.
+    bool succeeded() const {
+        for (const I2cTransfer& transfer : transfers_) {
+            if (transfer.status != I2cTransfer::Status::Ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Time from submission to completion.
+    uint32_t latency_cycles() const {
+        return latency_cycles_;
+    }
+
+   private:
+    template <typename Bus, typename Clock, typename Lock>
+    friend class I2cEngine;
+
+    Span<I2cTransfer> transfers_;
+    Callback on_complete_;
+    I2cBatch* next_ = nullptr;
+    uint32_t submitted_ = 0;
+    uint32_t latency_cycles_ = 0;
+    bool pending_ = false;
+};
+
+struct I2cStats {
+    uint32_t transfers;
+    uint32_t errors;
+    uint32_t batches;
+    uint32_t max_batch_latency_cycles;
+    /// Bus time and elapsed 'Clock' cycles since the statistics were
+    /// reset. The utilization is 'busy_cycles / window_cycles'.
+    uint32_t busy_cycles;
+    uint32_t window_cycles;
+    /// Completions reported while no transfer was in progress.
+    uint32_t spurious;
+};
+
+template <typename Bus, typename Clock, typename Lock>
+class I2cEngine {
+   public:
+    explicit I2cEngine(Bus& bus) : bus_ { bus } {
+        bus_.bind([this](bool ok) { on_done(ok); });
+        reset_stats();
+    }
+
+    I2cEngine(const I2cEngine&) = delete;
+    I2cEngine(I2cEngine&&) = delete;
+    I2cEngine& operator=(const I2cEngine&) = delete;
+    I2cEngine& operator=(I2cEngine&&) = delete;
+    ~I2cEngine() = default;
+
+    /// Queues 'batch' and starts it if the bus is idle. Panics if the batch
+    /// is still pending.
+    void submit(I2cBatch& batch) {
+        if (batch.pending_) {
+            panic("I2C batch is still pending");
+        }
+        for (I2cTransfer& transfer : batch.transfers_) {
+            transfer.status = I2cTransfer::Status::Pending;
+            transfer.cycles = 0;
+        }
+        batch.submitted_ = Clock::cycles();
+        batch.pending_ = true;
+        batch.next_ = nullptr;
+
+        bool idle;
+        {
+            const Lock lock;
+            *tail_ = &batch;
+            tail_ = &batch.next_;
+            idle = !busy_;
+            busy_ = true;
+        }
+        if (idle) {
+            start_next();
+        }
+    }
+
+    /// True if no batch is queued or in progress.
+    bool is_idle() const {
+        const Lock lock;
+        return !busy_;
+    }
+
+    /// Statistics since the last 'reset_stats'. The cycle counts wrap, so
+    /// the window must be shorter than 2^32 cycles.
+    I2cStats stats() const {
+        const Lock lock;
+        I2cStats stats = stats_;
+        stats.window_cycles = Clock::cycles() - window_start_;
+        return stats;
+    }
+
+    void reset_stats() {
+        const Lock lock;
+        stats_ = I2cStats {};
+        window_start_ = Clock::cycles();
+    }
+
+   private:
+    // Called with the bus idle. Starts the next transfer and completes the
+    // batches that have no transfers left.
+    void start_next() {
+        while (true) {
+            I2cBatch* finished = nullptr;
+            I2cTransfer* transfer = nullptr;
+            {
+                const Lock lock;
+                if (head_ == nullptr) {
+                    busy_ = false;
+                    return;
+                }
+                if (index_ < head_->transfers_.size()) {
+                    transfer = &head_->transfers_[index_];
+                } else {
+                    finished = head_;
+                    head_ = finished->next_;
+                    if (head_ == nullptr) {
+                        tail_ = &head_;
+                    }
+                    index_ = 0;
+                }
+            }
+            if (finished != nullptr) {
+                complete(*finished);
+                continue;
+            }
+            {
+                // The completion may interrupt 'begin'.
+                const Lock lock;
+                in_flight_ = true;
+            }
+            transfer_start_ = Clock::cycles();
+            if (bus_.begin(*transfer)) {
+                return;
+            }
+            {
+                const Lock lock;
+                in_flight_ = false;
+            }
+            finish_transfer(false);
+        }
+    }
+
+    // Called by the bus from its completion interrupt.
+    void on_done(bool ok) {
+        {
+            const Lock lock;
+            if (!in_flight_) {
+                ++stats_.spurious;
+                return;
+            }
+            in_flight_ = false;
+        }
+        finish_transfer(ok);
+        start_next();
+    }
+
+    void finish_transfer(bool ok) {
+        const uint32_t cycles = Clock::cycles() - transfer_start_;
+        I2cTransfer& transfer = head_->transfers_[index_];
+        transfer.status =
+            ok ? I2cTransfer::Status::Ok : I2cTransfer::Status::Error;
+        transfer.cycles = cycles;
+        ++index_;
+
+        ++stats_.transfers;
+        if (!ok) {
+            ++stats_.errors;
+        }
+        stats_.busy_cycles += cycles;
+    }
+
+    void complete(I2cBatch& batch) {
+        batch.latency_cycles_ = Clock::cycles() - batch.submitted_;
+        batch.next_ = nullptr;
+        batch.pending_ = false;
+
+        ++stats_.batches;
+        if (batch.latency_cycles_ > stats_.max_batch_latency_cycles) {
+            stats_.max_batch_latency_cycles = batch.latency_cycles_;
+        }
+        batch.on_complete_(batch);
+    }
+
+    Bus& bus_;
+
+    // Queue of pending batches, the head is the one in progress.
+    I2cBatch* head_ = nullptr;
+    I2cBatch** tail_ = &head_;
+    std::size_t index_ = 0;
+    uint32_t transfer_start_ = 0;
+    bool busy_ = false;
+    bool in_flight_ = false;
+
+    I2cStats stats_ {};
+    uint32_t window_start_ = 0;
+};
+
+namespace prelude {
+
+using ccl::I2cBatch;
+using ccl::I2cEngine;
+using ccl::I2cStats;
+using ccl::I2cTransfer;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,73 @@
+/// Uninitialized element storage for fixed-capacity containers.
+///
+/// For trivial types the storage is a plain array, so containers of them
+/// are trivially copyable and usable in constant expressions. Other types
+/// are constructed in place in raw storage; the containers are responsible
+/// for copying and destroying the live elements.
+
+#ifndef CCL_INLINE_STORAGE_HPP
+#define CCL_INLINE_STORAGE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ccl::detail {
+
+/// Smallest unsigned type that can hold values up to 'N'.
+template <std::size_t N>
+using size_type_for = std::conditional_t<
+    N <= UINT8_MAX,
+    uint8_t,
+    std::conditional_t<N <= UINT16_MAX, uint16_t, std::size_t>>;
+
+template <typename T, std::size_t N, bool = std::is_trivial_v<T>>
+struct InlineStorage {
+    std::array<T, N> elements_ {};
+
+    constexpr T* slot(std::size_t index) {
+        return &elements_[index];
+    }
+
+    constexpr const T* slot(std::size_t index) const {
+        return &elements_[index];
+    }
+
+    template <typename... Args>
+    constexpr void construct(std::size_t index, Args&&... args) {
+        elements_[index] = T { std::forward<Args>(args)... };
+    }
+
+    constexpr void destroy(std::size_t /*index*/) {}
+};
+
+template <typename T, std::size_t N>
+struct InlineStorage<T, N, false> {
+    alignas(T) unsigned char bytes_[sizeof(T) * N];
+
+    T* slot(std::size_t index) {
+        return std::launder(reinterpret_cast<T*>(bytes_) + index);
+    }
+
+    const T* slot(std::size_t index) const {
+        return std::launder(reinterpret_cast<const T*>(bytes_) + index);
+    }
+
+    template <typename... Args>
+    void construct(std::size_t index, Args&&... args) {
+        new (bytes_ + index * sizeof(T)) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(std::size_t index) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            slot(index)->~T();
+        }
+    }
+};
+
+}  // namespace ccl::detail
+
+#endif
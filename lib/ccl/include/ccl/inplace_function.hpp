@@ -0,0 +1,98 @@
+/// Type-erased callable with inline storage.
+///
+/// 'InplaceFunction<R(Args...), Capacity>' stores any callable of up to
+/// 'Capacity' bytes in place, it never allocates. Callables that do not fit
+/// are rejected at compile time instead of falling back to the heap.
+///
+/// Only trivially copyable callables are accepted, e.g. function pointers
+/// and lambdas capturing pointers or references. This keeps
+/// 'InplaceFunction' itself trivially copyable and a call costs a single
+/// indirect call, like a plain function pointer. Calling an empty function
+/// panics.
+///
+/// # Examples
+///
+/// ```
+/// InplaceFunction<void(uint16_t)> on_event = [this](uint16_t pos) {
+///     on_rx_event(pos);
+/// };
+/// on_event(42);
+/// ```
+
+#ifndef CCL_INPLACE_FUNCTION_HPP
+#define CCL_INPLACE_FUNCTION_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "panic.hpp"
+
+namespace ccl {
+
+template <typename Signature, std::size_t Capacity = 2 * sizeof(void*)>
+class InplaceFunction;
+
+template <typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+    using Invoker = R (*)(void*, Args...);
+
+    alignas(std::max_align_t) mutable unsigned char storage_[Capacity] {};
+    Invoker invoke_ = &invoke_empty;
+
+    template <typename F>
+    static R invoke(void* storage, Args... args) {
+        return (*std::launder(static_cast<F*>(storage)))(
+            std::forward<Args>(args)...
+        );
+    }
+
+    static R invoke_empty(void* /*storage*/, Args... /*args*/) {
+        panic("Called an empty InplaceFunction");
+    }
+
+   public:
+    InplaceFunction() = default;
+
+    template <
+        typename F,
+        typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, InplaceFunction>
+            && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    // NOLINTNEXTLINE(*-explicit-conversions)
+    InplaceFunction(F&& f) {
+        using Callable = std::decay_t<F>;
+        static_assert(
+            sizeof(Callable) <= Capacity,
+            "Callable does not fit in InplaceFunction"
+        );
+        static_assert(
+            alignof(Callable) <= alignof(std::max_align_t),
+            "Callable is over-aligned"
+        );
+        static_assert(
+            std::is_trivially_copyable_v<Callable>
+                && std::is_trivially_destructible_v<Callable>,
+            "Callable must be trivially copyable"
+        );
+        new (storage_) Callable(std::forward<F>(f));
+        invoke_ = &invoke<Callable>;
+    }
+
+    R operator()(Args... args) const {
+        return invoke_(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const {
+        return invoke_ != &invoke_empty;
+    }
+};
+
+namespace prelude {
+using ccl::InplaceFunction;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,145 @@
+/// Interrupt handler duration and latency accounting.
+///
+/// 'IrqMonitor<Capacity, Clock, Lock>' is called on entry to and exit from
+/// interrupt handlers and accumulates, per handler, the number of runs,
+/// the total and worst-case cycles spent in the handler and the worst-case
+/// entry latency. Handlers are identified by a slot below 'Capacity'.
+///
+/// Handlers preempted by higher priority ones are only charged for their
+/// own cycles: the monitor keeps a stack of the active handlers and
+/// subtracts the cycles of the nested handlers from the preempted one.
+/// With priority based preemption a nested handler always exits before the
+/// handler it preempted, and each slot is at most once on the stack.
+///
+/// The latency is the time from the interrupt request to the entry hook.
+/// Only the caller can tell when the request happened, e.g. from the timer
+/// that raised it, so it is passed to 'enter' and is zero when unknown.
+///
+/// 'Clock' provides 'static uint32_t cycles()'. 'Lock' is a critical
+/// section with respect to all monitored handlers, see 'TimerWheel'; it is
+/// held for a few cycles in 'enter' and 'exit'.
+///
+/// # Examples
+///
+/// ```
+/// IrqMonitor<8, SysTickClock, InterruptLock> monitor;
+///
+/// void SysTick_Handler() {
+///     monitor.enter(0, SysTick->LOAD - SysTick->VAL);
+///     HAL_IncTick();
+///     monitor.exit();
+/// }
+///
+/// const IrqStats stats = monitor.take(0);
+/// ```
+
+#ifndef CCL_IRQ_MONITOR_HPP
+#define CCL_IRQ_MONITOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "panic.hpp"
+
+namespace ccl {
+
+struct IrqStats {
+    uint32_t runs;
+    /// Cycles spent in the handler, without nested handlers.
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+    uint32_t max_latency_cycles;
+    /// Runs interrupted by a nested handler.
+    uint32_t preempted;
+};
+
+template <std::size_t Capacity, typename Clock, typename Lock>
+class IrqMonitor {
+   public:
+    static constexpr std::size_t capacity = Capacity;
+
+    IrqMonitor() = default;
+
+    IrqMonitor(const IrqMonitor&) = delete;
+    IrqMonitor(IrqMonitor&&) = delete;
+    IrqMonitor& operator=(const IrqMonitor&) = delete;
+    IrqMonitor& operator=(IrqMonitor&&) = delete;
+    ~IrqMonitor() = default;
+
+    /// Records the entry into the handler of 'slot', 'latency_cycles' after
+    /// its request.
+    void enter(std::size_t slot, uint32_t latency_cycles = 0) {
+        const Lock lock;
+        if (slot >= Capacity || depth_ == Capacity) {
+            panic("Invalid interrupt slot");
+        }
+        IrqStats& stats = stats_[slot];
+        if (latency_cycles > stats.max_latency_cycles) {
+            stats.max_latency_cycles = latency_cycles;
+        }
+        if (depth_ > 0) {
+            stack_[depth_ - 1].preempted = true;
+        }
+        stack_[depth_] = Frame { Clock::cycles(), 0, slot, false };
+        ++depth_;
+    }
+
+    /// Records the exit from the handler entered last.
+    void exit() {
+        const Lock lock;
+        const uint32_t now = Clock::cycles();
+        if (depth_ == 0) {
+            return;
+        }
+        --depth_;
+        const Frame& frame = stack_[depth_];
+        const uint32_t elapsed = now - frame.start;
+        const uint32_t own = elapsed - frame.nested;
+        if (depth_ > 0) {
+            stack_[depth_ - 1].nested += elapsed;
+        }
+
+        IrqStats& stats = stats_[frame.slot];
+        ++stats.runs;
+        stats.total_cycles += own;
+        if (own > stats.max_cycles) {
+            stats.max_cycles = own;
+        }
+        if (frame.preempted) {
+            ++stats.preempted;
+        }
+    }
+
+    /// Returns the stats of 'slot' and resets them.
+    IrqStats take(std::size_t slot) {
+        const Lock lock;
+        const IrqStats stats = stats_[slot];
+        stats_[slot] = IrqStats {};
+        return stats;
+    }
+
+   private:
+    struct Frame {
+        uint32_t start;
+        // Cycles spent in handlers nested in this one.
+        uint32_t nested;
+        std::size_t slot;
+        bool preempted;
+    };
+
+    std::array<IrqStats, Capacity> stats_ {};
+    std::array<Frame, Capacity> stack_ {};
+    std::size_t depth_ = 0;
+};
+
+namespace prelude {
+
+using ccl::IrqMonitor;
+using ccl::IrqStats;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,393 @@
+/// Deferred binary logging.
+///
+/// Format strings never reach the target's flash. Each 'CCL_LOG_*' call
+/// site places its format string in the non-loaded '.ccl_log' section,
+/// which the linker script puts at address 0, so the address of the string
+/// is a 16-bit id. At run time only the id and the binary encoded arguments
+/// are appended to 'log_buffer'. 'script/decode_log.py' reads the strings
+/// from the ELF file and turns the byte stream back into text.
+///
+/// Format strings use the printf syntax and are checked by the compiler.
+/// Supported conversions are 'd i u x X o c' with the 'hh h l ll z j t'
+/// length modifiers, 'p' and 'f F e E g G a A' (sent as 'float'). Each
+/// argument is sent in as many bytes as its conversion says, e.g. '%hhu'
+/// takes one byte. '%s' is not supported.
+///
+/// A frame is a length byte followed by the little-endian id and the
+/// arguments; the length excludes the length byte itself.
+///
+/// Logging is safe from any interrupt priority and from the main loop, see
+/// 'LogBuffer'. Messages that do not fit in the buffer are dropped and
+/// counted.
+///
+/// 'CCL_LOG_LEVEL' selects the compiled in levels: 0 error, 1 warning,
+/// 2 info, 3 debug (default). Disabled calls do not evaluate their
+/// arguments.
+///
+/// GCC ignores section attributes inside templates, so the macros must not
+/// be used in function templates or members of class templates. On ARM each
+/// call site also emits a 16-bit absolute relocation to its string into the
+/// non-loaded '.ccl_log_ids' section, so such calls, and more strings than
+/// 16-bit ids can address, fail to link with a truncated relocation.
+///
+/// # Examples
+///
+/// ```
+/// CCL_LOG_INFO("battery %hu mV, %d C", millivolts, temperature);
+///
+/// // In the transport task:
+/// auto chunk = log_buffer.peek();
+/// uart.transmit(chunk.data, chunk.size);
+/// log_buffer.consume(chunk.size);
+/// ```
+
+#ifndef CCL_LOG_HPP
+#define CCL_LOG_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifndef CCL_LOG_LEVEL
+#define CCL_LOG_LEVEL 3
+#endif
+
+#ifndef CCL_LOG_CAPACITY
+#define CCL_LOG_CAPACITY 1024
+#endif
+
+namespace ccl {
+
+/// Byte ring shared by any number of producers and a single consumer on
+/// a single core.
+///
+/// Producers reserve space with a compare-and-swap on the reserve index, so
+/// interrupts may log while they preempt another producer. The reserved
+/// bytes are published by the outermost producer when it finishes: with
+/// priority based preemption every producer that started later has
+/// completed by then.
+template <std::size_t Capacity>
+class LogBuffer {
+    static_assert(
+        (Capacity & (Capacity - 1)) == 0,
+        "Capacity must be a power of two"
+    );
+
+   public:
+    struct Chunk {
+        const uint8_t* data;
+        std::size_t size;
+    };
+
+    /// Appends the whole frame or nothing. Returns false if the frame was
+    /// dropped.
+    bool write(const uint8_t* data, std::size_t size) {
+        writers_.fetch_add(1, std::memory_order_acquire);
+
+        uint32_t head = reserved_.load(std::memory_order_relaxed);
+        bool fits;
+        do {
+            const uint32_t tail = tail_.load(std::memory_order_acquire);
+            fits = Capacity - (head - tail) >= size;
+        } while (fits
+                 && !reserved_.compare_exchange_weak(
+                     head,
+                     head + size,
+                     std::memory_order_relaxed
+                 ));
+
+        if (fits) {
+            const std::size_t offset = head & (Capacity - 1);
+            const std::size_t first =
+                size < Capacity - offset ? size : Capacity - offset;
+            std::memcpy(&buffer_[offset], data, first);
+            std::memcpy(&buffer_[0], data + first, size - first);
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (writers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            publish();
+        }
+        return fits;
+    }
+
+    /// Longest contiguous run of published bytes. The bytes stay valid
+    /// until they are consumed.
+    Chunk peek() const {
+        const uint32_t committed = committed_.load(std::memory_order_acquire);
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t offset = tail & (Capacity - 1);
+        const std::size_t size = committed - tail;
+        return Chunk {
+            &buffer_[offset],
+            size < Capacity - offset ? size : Capacity - offset,
+        };
+    }
+
+    /// Releases 'size' bytes returned by 'peek'.
+    void consume(std::size_t size) {
+        tail_.store(
+            tail_.load(std::memory_order_relaxed) + size,
+            std::memory_order_release
+        );
+    }
+
+    /// Number of frames dropped because the buffer was full.
+    uint32_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    void publish() {
+        const uint32_t reserved = reserved_.load(std::memory_order_acquire);
+        uint32_t committed = committed_.load(std::memory_order_relaxed);
+        // A preempting producer may have published more in the meantime,
+        // never move the index back.
+        while (static_cast<int32_t>(reserved - committed) > 0
+               && !committed_.compare_exchange_weak(
+                   committed,
+                   reserved,
+                   std::memory_order_release,
+                   std::memory_order_relaxed
+               )) {}
+    }
+
+    std::array<uint8_t, Capacity> buffer_ {};
+
+    // Free running byte counters, the buffer offset is the counter modulo
+    // Capacity.
+    std::atomic<uint32_t> reserved_ { 0 };
+    std::atomic<uint32_t> committed_ { 0 };
+    std::atomic<uint32_t> tail_ { 0 };
+    std::atomic<uint32_t> writers_ { 0 };
+    std::atomic<uint32_t> dropped_ { 0 };
+};
+
+extern LogBuffer<CCL_LOG_CAPACITY> log_buffer;
+
+namespace detail {
+
+struct LogArg {
+    uint8_t size;
+    bool floating;
+};
+
+struct LogFormat {
+    static constexpr std::size_t max_args = 8;
+
+    bool valid = true;
+    std::size_t count = 0;
+    std::size_t size = 0;
+    std::array<LogArg, max_args> args {};
+};
+
+constexpr LogFormat parse_log_format(const char* fmt) {
+    LogFormat format;
+    const char* it = fmt;
+    while (*it != '\0') {
+        if (*it++ != '%') {
+            continue;
+        }
+        if (*it == '%') {
+            ++it;
+            continue;
+        }
+        while (*it == '-' || *it == '+' || *it == ' ' || *it == '#'
+               || *it == '.' || (*it >= '0' && *it <= '9')) {
+            ++it;
+        }
+
+        uint8_t size = sizeof(int);
+        if (it[0] == 'h' && it[1] == 'h') {
+            size = sizeof(char);
+            it += 2;
+        } else if (it[0] == 'l' && it[1] == 'l') {
+            size = sizeof(long long);
+            it += 2;
+        } else if (*it == 'h') {
+            size = sizeof(short);
+            ++it;
+        } else if (*it == 'l') {
+            size = sizeof(long);
+            ++it;
+        } else if (*it == 'z') {
+            size = sizeof(std::size_t);
+            ++it;
+        } else if (*it == 'j') {
+            size = sizeof(intmax_t);
+            ++it;
+        } else if (*it == 't') {
+            size = sizeof(std::ptrdiff_t);
+            ++it;
+        }
+
+        LogArg arg { size, false };
+        switch (*it) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'c':
+                break;
+            case 'p':
+                arg.size = sizeof(void*);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                arg = LogArg { sizeof(float), true };
+                break;
+            default:
+                // '%s', '*' widths and 'L' are not supported.
+                format.valid = false;
+                return format;
+        }
+        ++it;
+
+        if (format.count == LogFormat::max_args) {
+            format.valid = false;
+            return format;
+        }
+        format.args[format.count++] = arg;
+        format.size += arg.size;
+    }
+    return format;
+}
+
+/// Never called, lets the compiler check the arguments against 'fmt'.
+__attribute__((format(printf, 1, 2))) inline void check_log_format(
+    const char* /*fmt*/,
+    ...
+) {}
+
+template <typename T>
+void encode_log_arg(uint8_t* out, LogArg arg, const T& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        const auto f = static_cast<float>(value);
+        std::memcpy(out, &f, sizeof(f));
+    } else {
+        uint64_t bits = 0;
+        if constexpr (std::is_pointer_v<T>) {
+            bits = reinterpret_cast<uintptr_t>(value);
+        } else if constexpr (std::is_enum_v<T>) {
+            bits = static_cast<uint64_t>(
+                static_cast<std::underlying_type_t<T>>(value)
+            );
+        } else {
+            bits = static_cast<uint64_t>(value);
+        }
+        if (arg.floating) {
+            const auto f = static_cast<float>(bits);
+            std::memcpy(out, &f, sizeof(f));
+        } else {
+            // Little-endian, the low bytes come first.
+            std::memcpy(out, &bits, arg.size);
+        }
+    }
+}
+
+template <typename F, typename... Args>
+void log(const char* id, F format, const Args&... args) {
+    constexpr LogFormat spec = format();
+    static_assert(spec.valid, "Unsupported log format");
+    static_assert(
+        spec.count == sizeof...(Args),
+        "Log format does not match the number of arguments"
+    );
+    static_assert(spec.size + 2 <= 0xFF, "Log message too long");
+
+    // Fits in 16 bits, checked at link time by 'CCL_LOG_CHECK_ID'.
+    const auto address = reinterpret_cast<uintptr_t>(id);
+
+    std::array<uint8_t, spec.size + 3> frame;
+    frame[0] = static_cast<uint8_t>(spec.size + 2);
+    frame[1] = static_cast<uint8_t>(address);
+    frame[2] = static_cast<uint8_t>(address >> 8);
+    std::size_t offset = 3;
+    std::size_t index = 0;
+    ((encode_log_arg(&frame[offset], spec.args[index], args),
+      offset += spec.args[index++].size),
+     ...);
+    log_buffer.write(frame.data(), frame.size());
+}
+
+}  // namespace detail
+
+}  // namespace ccl
+
+#define CCL_LOG_STRINGIFY_(x) #x
+#define CCL_LOG_STRINGIFY(x) CCL_LOG_STRINGIFY_(x)
+
+#ifdef __arm__
+// The linker reports a truncated relocation if 'symbol' is above 0xFFFF.
+#define CCL_LOG_CHECK_ID(symbol)                                          \
+    __asm__(                                                              \
+        ".pushsection .ccl_log_ids,\"\",%%progbits\n"                     \
+        ".short %c0\n"                                                    \
+        ".popsection" ::"i"(symbol)                                       \
+    )
+#else
+// Hosts keep the strings in memory and only use the low 16 bits of their
+// addresses, which is enough for tests that do not decode the ids.
+#define CCL_LOG_CHECK_ID(symbol) static_cast<void>(symbol)
+#endif
+
+// Every call site needs its own section name, otherwise GCC reports
+// a section type conflict between call sites in inline and non-inline
+// functions.
+#define CCL_LOG_IMPL(level, fmt, ...)                                     \
+    do {                                                                  \
+        if (false) {                                                      \
+            ::ccl::detail::check_log_format(fmt, ##__VA_ARGS__);          \
+        }                                                                 \
+        __attribute__((                                                   \
+            section(".ccl_log." CCL_LOG_STRINGIFY(__COUNTER__)), used     \
+        )) static const char ccl_log_fmt_[] = level fmt;                  \
+        CCL_LOG_CHECK_ID(ccl_log_fmt_);                                   \
+        ::ccl::detail::log(                                               \
+            ccl_log_fmt_,                                                 \
+            [] { return ::ccl::detail::parse_log_format(fmt); },          \
+            ##__VA_ARGS__                                                 \
+        );                                                                \
+    } while (false)
+
+// Keeps the arguments referenced without evaluating them.
+#define CCL_LOG_DISABLED(fmt, ...)                                        \
+    do {                                                                  \
+        if (false) {                                                      \
+            ::ccl::detail::check_log_format(fmt, ##__VA_ARGS__);          \
+        }                                                                 \
+    } while (false)
+
+#define CCL_LOG_ERROR(fmt, ...) CCL_LOG_IMPL("E", fmt, ##__VA_ARGS__)
+
+#if CCL_LOG_LEVEL >= 1
+#define CCL_LOG_WARN(fmt, ...) CCL_LOG_IMPL("W", fmt, ##__VA_ARGS__)
+#else
+#define CCL_LOG_WARN(fmt, ...) CCL_LOG_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if CCL_LOG_LEVEL >= 2
+#define CCL_LOG_INFO(fmt, ...) CCL_LOG_IMPL("I", fmt, ##__VA_ARGS__)
+#else
+#define CCL_LOG_INFO(fmt, ...) CCL_LOG_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#if CCL_LOG_LEVEL >= 3
+#define CCL_LOG_DEBUG(fmt, ...) CCL_LOG_IMPL("D", fmt, ##__VA_ARGS__)
+#else
+#define CCL_LOG_DEBUG(fmt, ...) CCL_LOG_DISABLED(fmt, ##__VA_ARGS__)
+#endif
+
+#endif
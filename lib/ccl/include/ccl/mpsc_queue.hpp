@@ -0,0 +1,130 @@
+/// Bounded lock-free multi-producer/single-consumer queue.
+///
+/// 'MpscQueue<T, N>' lets any number of interrupts post elements to one
+/// consumer, typically the main loop, without masking interrupts. Producers
+/// claim a slot by advancing the shared write index with a compare-and-swap,
+/// which GCC lowers to an LDREX/STREX loop on Cortex-M4. A producer that is
+/// preempted between the LDREX and the STREX loses the reservation and
+/// retries, so higher-priority interrupts never wait for lower-priority
+/// ones.
+///
+/// Every slot carries a sequence number that tells whether it is free for
+/// the producer of a given round or holds an element for the consumer. The
+/// consumer therefore sees elements only after they are completely written,
+/// in the order in which the slots were claimed. While a preempted producer
+/// has not finished writing its slot, 'pop' reports the queue as empty.
+///
+/// 'N' must be a power of two and 'T' trivially copyable.
+///
+/// # Examples
+///
+/// ```
+/// MpscQueue<Event, 16> events;
+///
+/// void EXTI15_10_IRQHandler() { events.try_push(Event::Button).unwrap(); }
+/// void TIM2_IRQHandler() { (void)events.try_push(Event::Tick); }
+///
+/// while (auto event = events.pop()) { handle(*event); }
+/// ```
+
+#ifndef CCL_MPSC_QUEUE_HPP
+#define CCL_MPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "capacity_error.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+template <typename T, std::size_t N>
+class MpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "T must be trivially copyable"
+    );
+
+   public:
+    MpscQueue() {
+        for (uint32_t i = 0; i < N; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+    ~MpscQueue() = default;
+
+    /// May be called from any context.
+    Result<Unit, CapacityError> try_push(const T& value) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[head & mask];
+            const uint32_t sequence =
+                slot->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<int32_t>(sequence - head);
+            if (lag == 0) {
+                if (head_.compare_exchange_weak(
+                        head,
+                        head + 1,
+                        std::memory_order_relaxed
+                    )) {
+                    break;
+                }
+            } else if (lag < 0) {
+                // The slot still holds the element of the previous round.
+                return Err { CapacityError::Full };
+            } else {
+                head = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(head + 1, std::memory_order_release);
+        return Ok { Unit {} };
+    }
+
+    /// May only be called from the single consumer.
+    std::optional<T> pop() {
+        Slot& slot = slots_[tail_ & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return std::nullopt;
+        }
+        const T value = slot.value;
+        slot.sequence.store(tail_ + N, std::memory_order_release);
+        ++tail_;
+        return value;
+    }
+
+    static constexpr std::size_t capacity() {
+        return N;
+    }
+
+   private:
+    static constexpr uint32_t mask = N - 1;
+
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        T value;
+    };
+
+    std::array<Slot, N> slots_ {};
+    std::atomic<uint32_t> head_ { 0 };
+    uint32_t tail_ = 0;
+};
+
+namespace prelude {
+using ccl::MpscQueue;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,42 @@
+/// Niche values.
+///
+/// A niche is a bit pattern that no valid value of a type has. 'Result'
+/// uses it to encode its discriminant inside the stored value instead of in
+/// a separate flag, so e.g. 'Result<Unit, E>' is only as large as 'E'.
+///
+/// 'Niche<T>' is specialized to declare the niche of 'T'. The niche value
+/// must never be used as a regular value of 'T'.
+///
+/// # Examples
+///
+/// ```
+/// enum class SensorError : uint8_t { Bus = 1, Timeout, Checksum };
+///
+/// template <>
+/// struct ccl::Niche<SensorError> {
+///     static constexpr SensorError value = SensorError { 0 };
+/// };
+///
+/// static_assert(sizeof(Result<Unit, SensorError>) == 1);
+/// ```
+
+#ifndef CCL_NICHE_HPP
+#define CCL_NICHE_HPP
+
+#include <type_traits>
+
+namespace ccl {
+
+template <typename T>
+struct Niche {};
+
+template <typename T, typename = void>
+inline constexpr bool has_niche = false;
+
+template <typename T>
+inline constexpr bool has_niche<T, std::void_t<decltype(Niche<T>::value)>> =
+    true;
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,67 @@
+/// Pointer that is never null.
+///
+/// 'NonNull<T>' can only be created from a reference, so null is its niche
+/// and 'Result<NonNull<T>, Unit>' is as large as a plain pointer.
+///
+/// # Examples
+///
+/// ```
+/// Result<NonNull<Device>, Unit> find_device(uint8_t address) {
+///     for (Device& device : devices) {
+///         if (device.address == address) { return Ok { NonNull { device } }; }
+///     }
+///     return Err { Unit {} };
+/// }
+/// ```
+
+#ifndef CCL_NON_NULL_HPP
+#define CCL_NON_NULL_HPP
+
+#include "niche.hpp"
+
+namespace ccl {
+
+template <typename T>
+class NonNull {
+    T* ptr_;
+
+    constexpr NonNull() : ptr_ { nullptr } {}
+
+    friend struct Niche<NonNull<T>>;
+
+   public:
+    constexpr explicit NonNull(T& ref) : ptr_ { &ref } {}
+
+    constexpr T* get() const {
+        return ptr_;
+    }
+
+    constexpr T& operator*() const {
+        return *ptr_;
+    }
+
+    constexpr T* operator->() const {
+        return ptr_;
+    }
+
+    friend constexpr bool operator==(NonNull lhs, NonNull rhs) {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend constexpr bool operator!=(NonNull lhs, NonNull rhs) {
+        return lhs.ptr_ != rhs.ptr_;
+    }
+};
+
+template <typename T>
+struct Niche<NonNull<T>> {
+    static constexpr NonNull<T> value {};
+};
+
+namespace prelude {
+using ccl::NonNull;
+}
+
+}  // namespace ccl
+
+#endif
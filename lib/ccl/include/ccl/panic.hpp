@@ -8,11 +8,18 @@
 
 namespace ccl {
 
-void panic(
+/// Reports an unrecoverable error and never returns. Calls 'panic_hook'
+/// and then halts.
+[[noreturn]] void panic(
     std::string_view msg,
     SourceLocation loc = SourceLocation::current()
 );
 
+/// Called by 'panic' before halting. The default definition does nothing.
+/// The application may provide its own definition, e.g. to store a crash
+/// record and reset the device.
+void panic_hook(std::string_view msg, SourceLocation loc);
+
 }  // namespace ccl
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+/// Fixed-block pool allocator.
+///
+/// 'Pool<T, N>' owns storage for 'N' objects of type 'T' and hands them out
+/// in constant time. Free blocks form a singly linked list of indices; the
+/// list head is updated with a compare-and-swap, so objects can be created
+/// and destroyed from interrupts and the main loop without masking
+/// interrupts. The head carries a tag that changes on every update, which
+/// prevents the ABA problem when a preempting context pops and pushes
+/// blocks between another context's load and compare-and-swap.
+///
+/// Exhaustion is reported as 'CapacityError::Full'. The pool tracks the
+/// current and peak number of blocks in use and the number of failed
+/// allocations.
+///
+/// # Examples
+///
+/// ```
+/// Pool<Frame, 8> frames;
+///
+/// NonNull<Frame> frame = frames.try_make(header).expect("Out of frames");
+/// ...
+/// frames.destroy(frame);
+/// ```
+
+#ifndef CCL_POOL_HPP
+#define CCL_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "capacity_error.hpp"
+#include "non_null.hpp"
+#include "panic.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+template <typename T, std::size_t N>
+class Pool {
+    static_assert(N > 0 && N < 0xFFFF, "Pool supports 1 to 65534 blocks");
+
+   public:
+    struct Stats {
+        uint32_t used;
+        uint32_t peak;
+        uint32_t failures;
+    };
+
+    Pool() {
+        for (std::size_t i = 0; i < N; ++i) {
+            next_[i].store(
+                static_cast<uint16_t>(i + 1),
+                std::memory_order_relaxed
+            );
+        }
+    }
+
+    Pool(const Pool&) = delete;
+    Pool(Pool&&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    Pool& operator=(Pool&&) = delete;
+    ~Pool() = default;
+
+    /// Creates an object in a free block.
+    template <typename... Args>
+    Result<NonNull<T>, CapacityError> try_make(Args&&... args) {
+        const std::size_t index = pop();
+        if (index == end) {
+            failures_.fetch_add(1, std::memory_order_relaxed);
+            return Err { CapacityError::Full };
+        }
+        T* object = new (block(index)) T(std::forward<Args>(args)...);
+        return Ok { NonNull<T> { *object } };
+    }
+
+    /// Destroys an object created by 'try_make' and frees its block.
+    /// Panics if the object does not belong to this pool.
+    void destroy(NonNull<T> object) {
+        // Pointers into other objects must not be subtracted or compared,
+        // compare their addresses instead.
+        const auto address = reinterpret_cast<std::uintptr_t>(object.get());
+        const auto begin = reinterpret_cast<std::uintptr_t>(storage_);
+        if (address < begin || address - begin >= sizeof(storage_)
+            || (address - begin) % sizeof(T) != 0) {
+            panic("Object does not belong to the pool");
+        }
+        object->~T();
+        push((address - begin) / sizeof(T));
+    }
+
+    Stats stats() const {
+        return Stats {
+            used_.load(std::memory_order_relaxed),
+            peak_.load(std::memory_order_relaxed),
+            failures_.load(std::memory_order_relaxed),
+        };
+    }
+
+    static constexpr std::size_t capacity() {
+        return N;
+    }
+
+   private:
+    static constexpr std::size_t end = N;
+
+    // The head packs the index of the first free block in the low and
+    // a modification tag in the high 16 bits.
+    static constexpr uint32_t pack(std::size_t index, uint32_t tag) {
+        return (tag << 16) | static_cast<uint32_t>(index);
+    }
+
+    void* block(std::size_t index) {
+        return storage_ + index * sizeof(T);
+    }
+
+    std::size_t pop() {
+        uint32_t head = head_.load(std::memory_order_acquire);
+        std::size_t index;
+        do {
+            index = head & 0xFFFF;
+            if (index == end) {
+                return end;
+            }
+            const uint16_t next =
+                next_[index].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(
+                    head,
+                    pack(next, (head >> 16) + 1),
+                    std::memory_order_acquire,
+                    std::memory_order_acquire
+                )) {
+                break;
+            }
+        } while (true);
+
+        const uint32_t used =
+            used_.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint32_t peak = peak_.load(std::memory_order_relaxed);
+        while (used > peak
+               && !peak_.compare_exchange_weak(
+                   peak,
+                   used,
+                   std::memory_order_relaxed
+               )) {}
+        return index;
+    }
+
+    void push(std::size_t index) {
+        used_.fetch_sub(1, std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        do {
+            next_[index].store(
+                static_cast<uint16_t>(head & 0xFFFF),
+                std::memory_order_relaxed
+            );
+        } while (!head_.compare_exchange_weak(
+            head,
+            pack(index, (head >> 16) + 1),
+            std::memory_order_release,
+            std::memory_order_relaxed
+        ));
+    }
+
+    alignas(T) unsigned char storage_[sizeof(T) * N];
+    std::atomic<uint16_t> next_[N];
+    std::atomic<uint32_t> head_ { pack(0, 0) };
+
+    std::atomic<uint32_t> used_ { 0 };
+    std::atomic<uint32_t> peak_ { 0 };
+    std::atomic<uint32_t> failures_ { 0 };
+};
+
+namespace prelude {
+using ccl::Pool;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,282 @@
+/// Scoped execution time profiling.
+///
+/// A 'ProfileZone<Clock>' measures the cycles from its construction to its
+/// destruction and adds them to a 'ProfileStats', which keeps the count,
+/// minimum, maximum and total cycles and a histogram with one bucket per
+/// power of two. Recording costs two reads of the cycle counter, a count
+/// leading zeros and a few loads and stores, so zones can stay enabled in
+/// flight builds.
+///
+/// 'ProfileStats' are statically allocated by their users and have a
+/// constant initializer, so a zone can be entered before 'main'. Zones are
+/// named and registered in a 'ProfileTable', which serializes them all into
+/// a compact binary frame for the ground, see 'script/decode_profile.py':
+///
+/// | Field           | Size | Content                                      |
+/// |-----------------|------|----------------------------------------------|
+/// | Magic           | 4    | "PROF"                                       |
+/// | Length          | 2    | Bytes following this field                   |
+/// | Zones, buckets  | 1, 1 |                                              |
+/// | Per zone        |      | Name length, name, count, min, max, total,   |
+/// |                 |      | a mask of the non-empty buckets, their counts |
+///
+/// All integers are little-endian, the total is 64-bit, the others 32-bit.
+///
+/// A 'ProfileStats' is not synchronized, each zone must only be entered
+/// from one interrupt priority or from the main loop. 'Lock' is a critical
+/// section with respect to the zones entered in interrupts, see
+/// 'TimerWheel'. 'Clock' provides 'static uint32_t cycles()', on the host
+/// 'SteadyClockCycles' counts nanoseconds. Zones must not last longer than
+/// the counter takes to wrap.
+///
+/// # Examples
+///
+/// ```
+/// ProfileStats filter_profile { "filter" };
+/// ProfileTable<8, InterruptLock> profiles;
+/// profiles.try_add(filter_profile).expect("Too many profile zones");
+///
+/// {
+///     const ProfileZone<SysTickClock> zone { filter_profile };
+///     run_filter();
+/// }
+///
+/// ByteWriter writer { frame };
+/// profiles.serialize(writer).expect("Profile frame too small");
+/// ```
+
+#ifndef CCL_PROFILE_HPP
+#define CCL_PROFILE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "bounds_error.hpp"
+#include "byte_io.hpp"
+#include "capacity_error.hpp"
+#include "non_null.hpp"
+#include "result.hpp"
+#include "span.hpp"
+#include "static_vector.hpp"
+#include "try.hpp"
+
+namespace ccl {
+
+class ProfileStats {
+   public:
+    /// Bucket 'i' counts durations of at least 2^i cycles and less than
+    /// 2^(i+1), bucket 0 also empty ones and the last bucket all longer
+    /// ones.
+    static constexpr std::size_t buckets = 24;
+
+    constexpr explicit ProfileStats(const char* name) : name_ { name } {}
+
+    ProfileStats(const ProfileStats&) = default;
+    ProfileStats(ProfileStats&&) = default;
+    ProfileStats& operator=(const ProfileStats&) = default;
+    ProfileStats& operator=(ProfileStats&&) = default;
+    ~ProfileStats() = default;
+
+    void add(uint32_t cycles) {
+        ++count_;
+        if (cycles < min_cycles_) {
+            min_cycles_ = cycles;
+        }
+        if (cycles > max_cycles_) {
+            max_cycles_ = cycles;
+        }
+        total_cycles_ += cycles;
+        const auto bucket =
+            static_cast<std::size_t>(31 - __builtin_clz(cycles | 1U));
+        ++histogram_[bucket < buckets ? bucket : buckets - 1];
+    }
+
+    void reset() {
+        *this = ProfileStats { name_ };
+    }
+
+    const char* name() const {
+        return name_;
+    }
+
+    uint32_t count() const {
+        return count_;
+    }
+
+    /// 'UINT32_MAX' while the count is zero.
+    uint32_t min_cycles() const {
+        return min_cycles_;
+    }
+
+    uint32_t max_cycles() const {
+        return max_cycles_;
+    }
+
+    uint64_t total_cycles() const {
+        return total_cycles_;
+    }
+
+    uint32_t mean_cycles() const {
+        return count_ > 0 ? static_cast<uint32_t>(total_cycles_ / count_) : 0;
+    }
+
+    const std::array<uint32_t, buckets>& histogram() const {
+        return histogram_;
+    }
+
+   private:
+    const char* name_;
+    uint32_t count_ = 0;
+    uint32_t min_cycles_ = std::numeric_limits<uint32_t>::max();
+    uint32_t max_cycles_ = 0;
+    uint64_t total_cycles_ = 0;
+    std::array<uint32_t, buckets> histogram_ {};
+};
+
+template <typename Clock>
+class ProfileZone {
+   public:
+    explicit ProfileZone(ProfileStats& stats)
+        : stats_ { stats }, start_ { Clock::cycles() } {}
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone(ProfileZone&&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+    ProfileZone& operator=(ProfileZone&&) = delete;
+
+    ~ProfileZone() {
+        stats_.add(Clock::cycles() - start_);
+    }
+
+   private:
+    ProfileStats& stats_;
+    uint32_t start_;
+};
+
+/// Cycle counter for profiling on the host, in nanoseconds.
+struct SteadyClockCycles {
+    static uint32_t cycles() {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()
+        );
+    }
+};
+
+template <std::size_t Capacity, typename Lock>
+class ProfileTable {
+   public:
+    static constexpr std::size_t capacity = Capacity;
+
+    ProfileTable() = default;
+
+    ProfileTable(const ProfileTable&) = delete;
+    ProfileTable(ProfileTable&&) = delete;
+    ProfileTable& operator=(const ProfileTable&) = delete;
+    ProfileTable& operator=(ProfileTable&&) = delete;
+    ~ProfileTable() = default;
+
+    /// Registers 'stats' for serialization. Must not be called while
+    /// 'serialize' or 'reset' runs.
+    Result<Unit, CapacityError> try_add(ProfileStats& stats) {
+        return zones_.try_push(NonNull { stats });
+    }
+
+    /// Returns a copy of the stats of the registered zone 'index'.
+    ProfileStats get(std::size_t index) const {
+        const Lock lock;
+        return *zones_[index];
+    }
+
+    std::size_t size() const {
+        return zones_.size();
+    }
+
+    /// Resets the stats of all registered zones.
+    void reset() {
+        for (const NonNull<ProfileStats> zone : zones_) {
+            const Lock lock;
+            zone->reset();
+        }
+    }
+
+    /// Writes a frame with the stats of all registered zones. Each zone is
+    /// copied with 'Lock' held, but the zones are not copied at the same
+    /// time.
+    Result<Unit, BoundsError> serialize(ByteWriter& writer) const {
+        static constexpr uint8_t magic[] = { 'P', 'R', 'O', 'F' };
+        CCL_TRY(writer.write_bytes(magic));
+        const std::size_t length_offset = writer.position();
+        CCL_TRY(writer.write<uint16_t>(0));
+        CCL_TRY(writer.write<uint8_t>(static_cast<uint8_t>(zones_.size())));
+        CCL_TRY(writer.write<uint8_t>(ProfileStats::buckets));
+
+        for (std::size_t i = 0; i < zones_.size(); ++i) {
+            CCL_TRY(write_zone(writer, get(i)));
+        }
+
+        const std::size_t length = writer.position() - length_offset - 2;
+        if (length > std::numeric_limits<uint16_t>::max()) {
+            return Err { BoundsError::OutOfBounds };
+        }
+        return writer.write_at<uint16_t>(
+            length_offset,
+            static_cast<uint16_t>(length)
+        );
+    }
+
+   private:
+    static_assert(Capacity <= std::numeric_limits<uint8_t>::max());
+    static_assert(ProfileStats::buckets <= 32);
+
+    static Result<Unit, BoundsError> write_zone(
+        ByteWriter& writer,
+        const ProfileStats& stats
+    ) {
+        std::size_t name_size = std::strlen(stats.name());
+        if (name_size > std::numeric_limits<uint8_t>::max()) {
+            name_size = std::numeric_limits<uint8_t>::max();
+        }
+        CCL_TRY(writer.write<uint8_t>(static_cast<uint8_t>(name_size)));
+        CCL_TRY(writer.write_bytes(
+            { reinterpret_cast<const uint8_t*>(stats.name()), name_size }
+        ));
+        CCL_TRY(writer.write<uint32_t>(stats.count()));
+        CCL_TRY(writer.write<uint32_t>(stats.min_cycles()));
+        CCL_TRY(writer.write<uint32_t>(stats.max_cycles()));
+        CCL_TRY(writer.write<uint64_t>(stats.total_cycles()));
+
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < ProfileStats::buckets; ++i) {
+            if (stats.histogram()[i] != 0) {
+                mask |= uint32_t { 1 } << i;
+            }
+        }
+        CCL_TRY(writer.write<uint32_t>(mask));
+        for (const uint32_t count : stats.histogram()) {
+            if (count != 0) {
+                CCL_TRY(writer.write<uint32_t>(count));
+            }
+        }
+        return Ok { Unit {} };
+    }
+
+    StaticVector<NonNull<ProfileStats>, Capacity> zones_;
+};
+
+namespace prelude {
+
+using ccl::ProfileStats;
+using ccl::ProfileTable;
+using ccl::ProfileZone;
+using ccl::SteadyClockCycles;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
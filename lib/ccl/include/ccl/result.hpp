@@ -11,13 +11,39 @@
 /// Result<T, E>. If the Result is Err then:
 /// * 'unwrap' - panics with generic message,
 /// * 'expect' - panics with provided message,
-/// * 'unwrap_or_else' - returns result of executing provided function.
+/// * 'unwrap_or_else' - returns result of executing provided function,
+/// * 'value_or' - returns provided default value.
 ///
 /// 'unwrap_err' may be used to extract contained error value.
 ///
+/// 'unwrap', 'unwrap_err' and 'expect' pass the location of their caller to
+/// 'panic', so crash records point at the failing call.
+///
+/// Results can be transformed and chained without branching by hand:
+/// * 'map' - applies a function to the contained value,
+/// * 'map_err' - applies a function to the contained error value,
+/// * 'and_then' - calls a function returning a Result with the contained
+///   value, errors are passed through,
+/// * 'or_else' - calls a function returning a Result with the contained
+///   error value, values are passed through.
+///
+/// 'ok' and 'err' convert a Result into an optional value or error.
+///
+/// Results of trivially copyable types can be used in constant
+/// expressions. Calling 'unwrap' or 'expect' on an error during constant
+/// evaluation is a compile error, which makes Result-returning functions
+/// usable for validating configuration at compile time.
+///
 /// 'Unit' type can be used in place of T for functions that may fail
 ///  but do not return a value.
 ///
+/// By default a Result stores a separate flag next to the value. If one of
+/// T and E is 'Unit' and the other one has a niche (see 'niche.hpp'),
+/// the flag is encoded in the niche instead, e.g. 'Result<Unit, E>' is as
+/// large as 'E' and fits in a register. The niche value itself can then not
+/// be stored: 'Ok' or 'Err' of it panics, so check a value before wrapping
+/// it, e.g. a status against its success value.
+///
 /// # Examples
 ///
 /// ```
@@ -40,19 +66,39 @@
 ///     }
 /// });
 /// ```
+///
+/// ```
+/// Result<uint8_t, I2cError> read_register(uint8_t reg);
+/// Result<Unit, I2cError> write_register(uint8_t reg, uint8_t value);
+///
+/// Result<Unit, SensorError> enable_sensor() {
+///     return read_register(CTRL_REG)
+///         .map([](uint8_t ctrl) { return ctrl | ENABLE_BIT; })
+///         .and_then([](uint8_t ctrl) {
+///             return write_register(CTRL_REG, ctrl);
+///         })
+///         .map_err([](I2cError) { return SensorError::Bus; });
+/// }
+/// ```
 
 #ifndef CCL_RESULT_HPP
 #define CCL_RESULT_HPP
 
+#include <optional>
+#include <type_traits>
 #include <utility>
 
 #include "branch_prediction.hpp"
+#include "niche.hpp"
 #include "panic.hpp"
 
 namespace ccl {
 
 struct Unit {};
 
+template <typename T, typename E>
+class Result;
+
 template <typename T>
 class Ok {
     T value_;
@@ -119,6 +165,32 @@ inline constexpr bool has_trivial_copy_move_destruct =
 
 // clang-format on
 
+template <typename T>
+inline constexpr bool is_result_v = false;
+
+template <typename T, typename E>
+inline constexpr bool is_result_v<Result<T, E>> = true;
+
+template <typename T>
+using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <typename F, typename Arg>
+using invoke_result_or_unit_t = std::conditional_t<
+    std::is_void_v<std::invoke_result_t<F&, Arg>>,
+    Unit,
+    remove_cvref_t<std::invoke_result_t<F&, Arg>>>;
+
+/// Invokes 'f' and returns its result, or 'Unit' if 'f' returns void.
+template <typename F, typename Arg>
+constexpr invoke_result_or_unit_t<F, Arg> invoke_or_unit(F& f, Arg&& arg) {
+    if constexpr (std::is_void_v<std::invoke_result_t<F&, Arg>>) {
+        f(std::forward<Arg>(arg));
+        return Unit {};
+    } else {
+        return f(std::forward<Arg>(arg));
+    }
+}
+
 template <
     typename T,
     typename E,
@@ -126,38 +198,50 @@ template <
         has_trivial_copy_move_destruct<T>&& has_trivial_copy_move_destruct<E>>
 struct ResultBase {
     union {
-        T ok;
-        E err;
+        T ok_;
+        E err_;
     };
 
     bool is_ok_;
 
     // NOLINTNEXTLINE(hicpp-explicit-conversions)
-    ResultBase(Ok<T>&& ok) : ok { std::move(ok).value() }, is_ok_ { true } {}
+    constexpr ResultBase(Ok<T>&& ok) :
+        ok_ { std::move(ok).value() },
+        is_ok_ { true } {}
 
     // NOLINTNEXTLINE(hicpp-explicit-conversions)
-    ResultBase(Err<E>&& err) :
-        err { std::move(err).value() },
+    constexpr ResultBase(Err<E>&& err) :
+        err_ { std::move(err).value() },
         is_ok_ { false } {}
+
+    constexpr bool holds_ok() const {
+        return is_ok_;
+    }
 };
 
 template <typename T, typename E>
 struct ResultBase<T, E, false> {
     union {
-        T ok;
-        E err;
+        T ok_;
+        E err_;
     };
 
     bool is_ok_;
 
     // NOLINTNEXTLINE(hicpp-explicit-conversions)
-    ResultBase(Ok<T>&& ok) : ok { std::move(ok).value() }, is_ok_ { true } {}
+    constexpr ResultBase(Ok<T>&& ok) :
+        ok_ { std::move(ok).value() },
+        is_ok_ { true } {}
 
     // NOLINTNEXTLINE(*-explicit-conversions)
-    ResultBase(Err<E>&& err) :
-        err { std::move(err).value() },
+    constexpr ResultBase(Err<E>&& err) :
+        err_ { std::move(err).value() },
         is_ok_ { false } {}
 
+    constexpr bool holds_ok() const {
+        return is_ok_;
+    }
+
     // NOLINTNEXTLINE(*-member-init)
     ResultBase(const ResultBase& other) {
         construct(other);
@@ -182,11 +266,11 @@ struct ResultBase<T, E, false> {
     ~ResultBase() {
         if (is_ok_) {
             if constexpr (!std::is_trivially_destructible_v<T>) {
-                ok.~T();  // NOLINT (*-union-access)
+                ok_.~T();  // NOLINT (*-union-access)
             }
         } else {
             if constexpr (!std::is_trivially_destructible_v<E>) {
-                err.~E();  // NOLINT (*-union-access)
+                err_.~E();  // NOLINT (*-union-access)
             }
         }
     };
@@ -195,9 +279,9 @@ struct ResultBase<T, E, false> {
     void construct(R&& other) {
         this->is_ok_ = other.is_ok_;
         if (this->is_ok_) {
-            new (&this->ok) auto(std::forward<R>(other).ok);
+            new (&this->ok_) auto(std::forward<R>(other).ok_);
         } else {
-            new (&this->err) auto(std::forward<R>(other).err);
+            new (&this->err_) auto(std::forward<R>(other).err_);
         }
     }
 
@@ -205,136 +289,388 @@ struct ResultBase<T, E, false> {
     void assign(R&& other) {
         if (other.is_ok_) {
             if (this->is_ok_) {
-                this->ok = std::forward<R>(other).ok;
+                this->ok_ = std::forward<R>(other).ok_;
             } else {
                 if constexpr (!std::is_trivially_destructible_v<E>) {
-                    this->err.~E();
+                    this->err_.~E();
                 }
-                new (&this->ok) auto(std::forward<R>(other).ok);
+                new (&this->ok_) auto(std::forward<R>(other).ok_);
                 this->is_ok_ = true;
             }
         } else {
             if (this->is_ok_) {
                 if constexpr (!std::is_trivially_destructible_v<T>) {
-                    this->ok.~T();
+                    this->ok_.~T();
                 }
-                new (&this->err) auto(std::forward<R>(other).err);
+                new (&this->err_) auto(std::forward<R>(other).err_);
                 this->is_ok_ = false;
             } else {
-                this->err = std::forward<R>(other).err;
+                this->err_ = std::forward<R>(other).err_;
             }
         }
     }
 };
 
+template <typename T, typename E>
+inline constexpr bool use_niche_layout =
+    (std::is_same_v<T, Unit> && has_niche<E>
+     && has_trivial_copy_move_destruct<E>)
+    || (std::is_same_v<E, Unit> && has_niche<T>
+        && has_trivial_copy_move_destruct<T>);
+
+/// Layout without a flag. The 'Unit' member takes no space, the other
+/// member holds its niche value when the Result is in the 'Unit' state.
+template <typename T, typename E>
+struct NicheResultBase {
+    static constexpr bool ok_is_unit = std::is_same_v<T, Unit>;
+
+    [[no_unique_address]] T ok_;
+    [[no_unique_address]] E err_;
+
+    // NOLINTNEXTLINE(hicpp-explicit-conversions)
+    constexpr NicheResultBase(Ok<T>&& ok) :
+        ok_ { std::move(ok).value() },
+        err_ { niche_or_unit<E>() } {
+        if (CCL_UNLIKELY(!holds_ok())) {
+            panic("Result holds a niche value");
+        }
+    }
+
+    // NOLINTNEXTLINE(hicpp-explicit-conversions)
+    constexpr NicheResultBase(Err<E>&& err) :
+        ok_ { niche_or_unit<T>() },
+        err_ { std::move(err).value() } {
+        if (CCL_UNLIKELY(holds_ok())) {
+            panic("Result holds a niche value");
+        }
+    }
+
+    constexpr bool holds_ok() const {
+        if constexpr (ok_is_unit) {
+            return err_ == Niche<E>::value;
+        } else {
+            return !(ok_ == Niche<T>::value);
+        }
+    }
+
+   private:
+    template <typename U>
+    static constexpr U niche_or_unit() {
+        if constexpr (std::is_same_v<U, Unit>) {
+            return Unit {};
+        } else {
+            return Niche<U>::value;
+        }
+    }
+};
+
+template <typename T, typename E>
+using ResultBaseFor = std::conditional_t<
+    use_niche_layout<T, E>,
+    NicheResultBase<T, E>,
+    ResultBase<T, E>>;
+
 }  // namespace detail
 
 template <typename T, typename E>
-class [[nodiscard]] Result : detail::ResultBase<T, E> {
-    using Base = detail::ResultBase<T, E>;
+class [[nodiscard]] Result : detail::ResultBaseFor<T, E> {
+    using Base = detail::ResultBaseFor<T, E>;
 
    public:
+    using value_type = T;
+    using error_type = E;
+
     // NOLINTNEXTLINE(*-explicit-conversions)
-    Result(Ok<T>&& ok) : Base { std::move(ok) } {}
+    constexpr Result(Ok<T>&& ok) : Base { std::move(ok) } {}
 
     // NOLINTNEXTLINE(*-explicit-conversions)
-    Result(Err<E>&& err) : Base { std::move(err) } {}
+    constexpr Result(Err<E>&& err) : Base { std::move(err) } {}
+
+    /// Converts an error of another type, e.g. when propagating it with
+    /// 'CCL_TRY' from a function with a more general error type.
+    template <
+        typename G,
+        typename = std::enable_if_t<
+            !std::is_same_v<G, E> && std::is_convertible_v<G, E>>>
+    // NOLINTNEXTLINE(*-explicit-conversions)
+    constexpr Result(Err<G>&& err) :
+        Base { Err<E> { static_cast<E>(std::move(err).value()) } } {}
 
-    bool is_ok() const {
-        return this->is_ok_;
+    constexpr bool is_ok() const {
+        return this->holds_ok();
     }
 
-    bool is_err() const {
-        return !this->is_ok_;
+    constexpr bool is_err() const {
+        return !this->holds_ok();
     }
 
-    T& unwrap() & {
-        return unwrap_impl(*this);
+    constexpr T& unwrap(
+        SourceLocation loc = SourceLocation::current()
+    ) & {
+        return unwrap_impl(*this, loc);
     }
 
-    T&& unwrap() && {
-        return unwrap_impl(std::move(*this));
+    constexpr T&& unwrap(
+        SourceLocation loc = SourceLocation::current()
+    ) && {
+        return unwrap_impl(std::move(*this), loc);
     }
 
-    const T& unwrap() const& {
-        return unwrap_impl(*this);
+    constexpr const T& unwrap(
+        SourceLocation loc = SourceLocation::current()
+    ) const& {
+        return unwrap_impl(*this, loc);
     }
 
-    const T&& unwrap() const&& {
-        return unwrap_impl(std::move(*this));
+    constexpr const T&& unwrap(
+        SourceLocation loc = SourceLocation::current()
+    ) const&& {
+        return unwrap_impl(std::move(*this), loc);
     }
 
-    E& unwrap_err() & {
-        return unwrap_err_impl(*this);
+    constexpr E& unwrap_err(
+        SourceLocation loc = SourceLocation::current()
+    ) & {
+        return unwrap_err_impl(*this, loc);
     }
 
-    E&& unwrap_err() && {
-        return unwrap_err_impl(std::move(*this));
+    constexpr E&& unwrap_err(
+        SourceLocation loc = SourceLocation::current()
+    ) && {
+        return unwrap_err_impl(std::move(*this), loc);
     }
 
-    const E& unwrap_err() const& {
-        return unwrap_err_impl(*this);
+    constexpr const E& unwrap_err(
+        SourceLocation loc = SourceLocation::current()
+    ) const& {
+        return unwrap_err_impl(*this, loc);
     }
 
-    const E&& unwrap_err() const&& {
-        return unwrap_err_impl(std::move(*this));
+    constexpr const E&& unwrap_err(
+        SourceLocation loc = SourceLocation::current()
+    ) const&& {
+        return unwrap_err_impl(std::move(*this), loc);
     }
 
     template <typename F>
-    T unwrap_or_else(F f) const& {
+    constexpr T unwrap_or_else(F f) const& {
         return unwrap_or_else_impl(*this, f);
     }
 
     template <typename F>
-    T unwrap_or_else(F f) && {
+    constexpr T unwrap_or_else(F f) && {
         return unwrap_or_else_impl(std::move(*this), f);
     }
 
-    T& expect(std::string_view msg) & {
-        return expect_impl(*this, msg);
+    constexpr T& expect(
+        std::string_view msg,
+        SourceLocation loc = SourceLocation::current()
+    ) & {
+        return expect_impl(*this, msg, loc);
+    }
+
+    constexpr T&& expect(
+        std::string_view msg,
+        SourceLocation loc = SourceLocation::current()
+    ) && {
+        return expect_impl(std::move(*this), msg, loc);
     }
 
-    T&& expect(std::string_view msg) && {
-        return expect_impl(std::move(*this), msg);
+    constexpr const T& expect(
+        std::string_view msg,
+        SourceLocation loc = SourceLocation::current()
+    ) const& {
+        return expect_impl(*this, msg, loc);
     }
 
-    const T& expect(std::string_view msg) const& {
-        return expect_impl(*this, msg);
+    constexpr const T&& expect(
+        std::string_view msg,
+        SourceLocation loc = SourceLocation::current()
+    ) const&& {
+        return expect_impl(std::move(*this), msg, loc);
     }
 
-    const T&& expect(std::string_view msg) const&& {
-        return expect_impl(std::move(*this), msg);
+    constexpr T value_or(T other) const& {
+        if (is_ok()) {
+            return this->ok_;
+        }
+        return other;
+    }
+
+    constexpr T value_or(T other) && {
+        if (is_ok()) {
+            return std::move(this->ok_);
+        }
+        return other;
+    }
+
+    template <typename F>
+    constexpr auto map(F f) const& {
+        return map_impl(*this, f);
+    }
+
+    template <typename F>
+    constexpr auto map(F f) && {
+        return map_impl(std::move(*this), f);
+    }
+
+    template <typename F>
+    constexpr auto map_err(F f) const& {
+        return map_err_impl(*this, f);
+    }
+
+    template <typename F>
+    constexpr auto map_err(F f) && {
+        return map_err_impl(std::move(*this), f);
+    }
+
+    template <typename F>
+    constexpr auto and_then(F f) const& {
+        return and_then_impl(*this, f);
+    }
+
+    template <typename F>
+    constexpr auto and_then(F f) && {
+        return and_then_impl(std::move(*this), f);
+    }
+
+    template <typename F>
+    constexpr auto or_else(F f) const& {
+        return or_else_impl(*this, f);
+    }
+
+    template <typename F>
+    constexpr auto or_else(F f) && {
+        return or_else_impl(std::move(*this), f);
+    }
+
+    constexpr std::optional<T> ok() const& {
+        return ok_impl(*this);
+    }
+
+    constexpr std::optional<T> ok() && {
+        return ok_impl(std::move(*this));
+    }
+
+    constexpr std::optional<E> err() const& {
+        return err_impl(*this);
+    }
+
+    constexpr std::optional<E> err() && {
+        return err_impl(std::move(*this));
     }
 
    private:
     template <typename Self>
-    static auto&& unwrap_impl(Self&& self) {
+    static constexpr auto&& unwrap_impl(Self&& self, SourceLocation loc) {
         if (CCL_UNLIKELY(self.is_err())) {
-            panic("unwrap");
+            panic("unwrap", loc);
         }
-        return std::forward<Self>(self).ok;  // NOLINT (*-union-access)
+        return std::forward<Self>(self).ok_;  // NOLINT (*-union-access)
     }
 
     template <typename Self>
-    static auto&& unwrap_err_impl(Self&& self) {
+    static constexpr auto&& unwrap_err_impl(Self&& self, SourceLocation loc) {
         if (CCL_UNLIKELY(self.is_ok())) {
-            panic("unwrap_err");
+            panic("unwrap_err", loc);
         }
-        return std::forward<Self>(self).err;
+        return std::forward<Self>(self).err_;
     }
 
     template <typename Self, typename F>
-    static T unwrap_or_else_impl(Self&& self, F f) {
-        return self.is_ok() ? std::forward<Self>(self).ok
-                            : f(std::forward<Self>(self).err);
+    static constexpr T unwrap_or_else_impl(Self&& self, F f) {
+        return self.is_ok() ? std::forward<Self>(self).ok_
+                            : f(std::forward<Self>(self).err_);
     }
 
     template <typename Self>
-    static auto&& expect_impl(Self&& self, std::string_view msg) {
+    static constexpr auto&& expect_impl(
+        Self&& self,
+        std::string_view msg,
+        SourceLocation loc
+    ) {
         if (CCL_UNLIKELY(self.is_err())) {
-            panic(msg);
+            panic(msg, loc);
+        }
+        return std::forward<Self>(self).ok_;
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto map_impl(Self&& self, F& f) {
+        using Arg = decltype((std::forward<Self>(self).ok_));
+        using U = detail::invoke_result_or_unit_t<F, Arg>;
+        if (self.is_ok()) {
+            return Result<U, E> { Ok<U> { detail::invoke_or_unit(
+                f,
+                std::forward<Self>(self).ok_
+            ) } };
+        }
+        return Result<U, E> { Err<E> { std::forward<Self>(self).err_ } };
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto map_err_impl(Self&& self, F& f) {
+        using Arg = decltype((std::forward<Self>(self).err_));
+        using G = detail::invoke_result_or_unit_t<F, Arg>;
+        if (self.is_err()) {
+            return Result<T, G> { Err<G> { detail::invoke_or_unit(
+                f,
+                std::forward<Self>(self).err_
+            ) } };
+        }
+        return Result<T, G> { Ok<T> { std::forward<Self>(self).ok_ } };
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto and_then_impl(Self&& self, F& f) {
+        using Arg = decltype((std::forward<Self>(self).ok_));
+        using R = detail::remove_cvref_t<std::invoke_result_t<F&, Arg>>;
+        static_assert(
+            detail::is_result_v<R>,
+            "and_then requires a function returning Result"
+        );
+        static_assert(
+            std::is_same_v<typename R::error_type, E>,
+            "and_then requires a function returning the same error type"
+        );
+        if (self.is_ok()) {
+            return R { f(std::forward<Self>(self).ok_) };
+        }
+        return R { Err<E> { std::forward<Self>(self).err_ } };
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto or_else_impl(Self&& self, F& f) {
+        using Arg = decltype((std::forward<Self>(self).err_));
+        using R = detail::remove_cvref_t<std::invoke_result_t<F&, Arg>>;
+        static_assert(
+            detail::is_result_v<R>,
+            "or_else requires a function returning Result"
+        );
+        static_assert(
+            std::is_same_v<typename R::value_type, T>,
+            "or_else requires a function returning the same value type"
+        );
+        if (self.is_err()) {
+            return R { f(std::forward<Self>(self).err_) };
+        }
+        return R { Ok<T> { std::forward<Self>(self).ok_ } };
+    }
+
+    template <typename Self>
+    static constexpr std::optional<T> ok_impl(Self&& self) {
+        if (self.is_ok()) {
+            return std::forward<Self>(self).ok_;
+        }
+        return std::nullopt;
+    }
+
+    template <typename Self>
+    static constexpr std::optional<E> err_impl(Self&& self) {
+        if (self.is_err()) {
+            return std::forward<Self>(self).err_;
         }
-        return std::forward<Self>(self).ok;
+        return std::nullopt;
     }
 };
 
@@ -0,0 +1,214 @@
+/// Cooperative run-to-completion task scheduler.
+///
+/// 'Scheduler<Clock, N>' runs a fixed set of periodic tasks. Tasks are
+/// described by a constant table of 'Task' entries that lives in flash;
+/// the scheduler itself only keeps the release times and statistics, so it
+/// does not allocate.
+///
+/// Each task is released every 'period' ticks, starting at 'phase'. When
+/// several tasks are due the one with the lowest 'priority' value runs
+/// first. Tasks are never preempted by other tasks, only by interrupts.
+/// A task misses its deadline if it has not finished before its next
+/// release. Releases that could not be served at all are skipped and also
+/// counted as deadline misses.
+///
+/// A task with a 'ready' function is also released whenever it returns
+/// true, e.g. when an interrupt has queued work for it, without waiting for
+/// the next periodic release. The period then only bounds the time between
+/// runs. Such extra runs have no deadline. 'ready' is called from the main
+/// loop on every pass and must be cheap.
+///
+/// 'Clock' is a policy type that provides:
+/// * 'static uint32_t now()' - current time in ticks,
+/// * 'static uint32_t cycles()' - free running cycle counter used to
+///   measure the execution time of tasks,
+/// * 'static void idle_until(uint32_t deadline)' - waits until an
+///   interrupt occurs or 'deadline' tick is reached. Work signalled to a
+///   'ready' function by an interrupt that ran just before the wait is only
+///   picked up after it, unless the clock checks for it with interrupts
+///   masked.
+///
+/// Using a simulated clock the scheduler can be run on the host.
+///
+/// # Examples
+///
+/// ```
+/// void blink();
+/// void poll_uart();
+///
+/// bool uart_has_input();
+///
+/// constexpr Task tasks[] = {
+///     { "uart", poll_uart, 100, 0, 0, uart_has_input },
+///     { "led", blink, 1000, 0, 1 },
+/// };
+/// static_assert(is_valid_schedule(tasks));
+///
+/// Scheduler<SysTickClock, std::size(tasks)> scheduler { tasks };
+/// scheduler.run();
+/// ```
+
+#ifndef CCL_SCHEDULER_HPP
+#define CCL_SCHEDULER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ccl {
+
+struct Task {
+    const char* name;
+    void (*function)();
+    uint32_t period;
+    uint32_t phase;
+    uint8_t priority;
+    /// Optional, releases the task early while it returns true.
+    bool (*ready)() = nullptr;
+};
+
+struct TaskStats {
+    uint32_t runs;
+    uint32_t deadline_misses;
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+};
+
+template <std::size_t N>
+constexpr bool is_valid_schedule(const Task (&tasks)[N]) {
+    for (const Task& task : tasks) {
+        if (task.function == nullptr || task.period == 0
+            || task.phase >= task.period) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Clock, std::size_t N>
+class Scheduler {
+    static_assert(N > 0, "Scheduler needs at least one task");
+
+    struct TaskState {
+        uint32_t next_release;
+        TaskStats stats;
+    };
+
+    const Task* tasks_;
+    std::array<TaskState, N> states_ {};
+
+   public:
+    explicit Scheduler(const Task (&tasks)[N]) : tasks_ { tasks } {
+        const uint32_t now = Clock::now();
+        for (std::size_t i = 0; i < N; ++i) {
+            states_[i].next_release = now + tasks[i].phase;
+        }
+    }
+
+    /// Runs the scheduler forever, idling while no task is due.
+    [[noreturn]] void run() {
+        while (true) {
+            if (!run_once()) {
+                Clock::idle_until(next_release());
+            }
+        }
+    }
+
+    /// Runs the most urgent task that is due. Returns false if no task was
+    /// due.
+    bool run_once() {
+        const uint32_t now = Clock::now();
+
+        std::size_t selected = N;
+        for (std::size_t i = 0; i < N; ++i) {
+            if (is_released(i, now)
+                && (selected == N
+                    || tasks_[i].priority < tasks_[selected].priority)) {
+                selected = i;
+            }
+        }
+        if (selected == N) {
+            return false;
+        }
+
+        dispatch(selected, now);
+        return true;
+    }
+
+    /// Release time of the earliest task.
+    uint32_t next_release() const {
+        const uint32_t now = Clock::now();
+        uint32_t earliest = std::numeric_limits<uint32_t>::max();
+        for (std::size_t i = 0; i < N; ++i) {
+            if (is_released(i, now)) {
+                return now;
+            }
+            const uint32_t remaining = states_[i].next_release - now;
+            if (remaining < earliest) {
+                earliest = remaining;
+            }
+        }
+        return now + earliest;
+    }
+
+    const TaskStats& stats(std::size_t index) const {
+        return states_[index].stats;
+    }
+
+    const Task& task(std::size_t index) const {
+        return tasks_[index];
+    }
+
+    static constexpr std::size_t size() {
+        return N;
+    }
+
+   private:
+    static bool is_due(uint32_t release, uint32_t now) {
+        return static_cast<int32_t>(now - release) >= 0;
+    }
+
+    bool is_released(std::size_t index, uint32_t now) const {
+        return is_due(states_[index].next_release, now)
+            || (tasks_[index].ready != nullptr && tasks_[index].ready());
+    }
+
+    void dispatch(std::size_t index, uint32_t now) {
+        const Task& task = tasks_[index];
+        TaskState& state = states_[index];
+
+        // Runs released by 'ready' keep the periodic releases.
+        const bool periodic = is_due(state.next_release, now);
+        if (periodic) {
+            // Skip releases that are already over.
+            const uint32_t late = now - state.next_release;
+            if (late >= task.period) {
+                const uint32_t skipped = late / task.period;
+                state.stats.deadline_misses += skipped;
+                state.next_release += skipped * task.period;
+            }
+            state.next_release += task.period;
+        }
+
+        const uint32_t start = Clock::cycles();
+        task.function();
+        const uint32_t cycles = Clock::cycles() - start;
+
+        const uint32_t end = Clock::now();
+        if (periodic && static_cast<int32_t>(end - state.next_release) > 0) {
+            ++state.stats.deadline_misses;
+        }
+        ++state.stats.runs;
+        state.stats.last_cycles = cycles;
+        if (cycles > state.stats.max_cycles) {
+            state.stats.max_cycles = cycles;
+        }
+        state.stats.total_cycles += cycles;
+    }
+};
+
+}  // namespace ccl
+
+#endif
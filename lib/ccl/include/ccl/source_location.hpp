@@ -4,6 +4,13 @@
 /// SourceLocation can be used as a function's default parameter to
 /// automatically get the location of the function call.
 ///
+/// If 'CCL_COMPACT_SOURCE_LOCATION' is defined, only a 32-bit 'id' made of
+/// a 16-bit hash of the file name and the line number is kept. The hash is
+/// computed at compile time, so neither the path nor the function name end
+/// up in flash. 'file' and 'function' then return "?" and
+/// 'script/decode_location.py' maps ids back to file, function and line
+/// using the debug information of the ELF file.
+///
 /// # Examples
 ///
 /// ```
@@ -21,8 +28,70 @@
 #ifndef CCL_SOURCE_LOCATION_HPP
 #define CCL_SOURCE_LOCATION_HPP
 
+#include <cstdint>
+
 namespace ccl {
 
+namespace detail {
+
+/// FNV-1a hash of the file name without its directory, folded to 16 bits.
+constexpr uint32_t file_hash(const char* path) {
+    const char* name = path;
+    for (const char* it = path; *it != '\0'; ++it) {
+        if (*it == '/' || *it == '\\') {
+            name = it + 1;
+        }
+    }
+    uint32_t hash = 2166136261u;
+    for (; *name != '\0'; ++name) {
+        hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+    }
+    return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+constexpr uint32_t location_id(const char* file, int line) {
+    const uint32_t clamped = line < 0 ? 0 : line > 0xFFFF ? 0xFFFF : line;
+    return (file_hash(file) << 16) | clamped;
+}
+
+}  // namespace detail
+
+#ifdef CCL_COMPACT_SOURCE_LOCATION
+
+class SourceLocation {
+    uint32_t id_ = 0;
+
+   public:
+    constexpr SourceLocation() = default;
+
+    static constexpr SourceLocation current(
+        uint32_t id = detail::location_id(__builtin_FILE(), __builtin_LINE())
+    ) {
+        SourceLocation loc;
+        loc.id_ = id;
+        return loc;
+    }
+
+    constexpr const char* file() const {
+        return "?";
+    }
+
+    constexpr const char* function() const {
+        return "?";
+    }
+
+    constexpr int line() const {
+        return static_cast<int>(id_ & 0xFFFF);
+    }
+
+    /// File name hash in the upper and line number in the lower 16 bits.
+    constexpr uint32_t id() const {
+        return id_;
+    }
+};
+
+#else
+
 class SourceLocation {
     const char* file_ = "unknown";
     const char* function_ = file_;
@@ -54,8 +123,15 @@ class SourceLocation {
     constexpr int line() const {
         return line_;
     }
+
+    /// Same value as in the compact representation, computed on demand.
+    constexpr uint32_t id() const {
+        return detail::location_id(file_, line_);
+    }
 };
 
+#endif
+
 namespace prelude {
 using ccl::SourceLocation;
 }
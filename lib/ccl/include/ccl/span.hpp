@@ -0,0 +1,183 @@
+/// Non-owning view of a contiguous sequence.
+///
+/// 'Span<T>' is a pointer and a size, a subset of C++20 'std::span' with
+/// a dynamic extent. It converts implicitly from arrays and from containers
+/// with 'data' and 'size', e.g. 'std::array' and 'StaticVector', and from
+/// 'Span<U>' where 'U*' converts to 'T*', so 'Span<uint8_t>' converts to
+/// 'Span<const uint8_t>'.
+///
+/// Like the standard containers, element access and the slicing functions
+/// do not check their arguments.
+///
+/// # Examples
+///
+/// ```
+/// void send(Span<const uint8_t> bytes);
+///
+/// std::array<uint8_t, 8> frame {};
+/// send(frame);
+/// send(Span { frame }.first(4));
+/// ```
+
+#ifndef CCL_SPAN_HPP
+#define CCL_SPAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace ccl {
+
+namespace detail {
+
+template <typename C>
+using span_element_t =
+    std::remove_pointer_t<decltype(std::data(std::declval<C&>()))>;
+
+template <typename C, typename T, typename = void>
+struct is_span_compatible : std::false_type {};
+
+// NOLINTBEGIN(*-avoid-c-arrays)
+template <typename C, typename T>
+struct is_span_compatible<
+    C,
+    T,
+    std::void_t<
+        decltype(std::data(std::declval<C&>())),
+        decltype(std::size(std::declval<C&>()))>>
+    : std::is_convertible<span_element_t<C> (*)[], T (*)[]> {};
+// NOLINTEND(*-avoid-c-arrays)
+
+}  // namespace detail
+
+template <typename T>
+class Span {
+   public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    constexpr Span() = default;
+
+    constexpr Span(T* data, std::size_t size)
+        : data_ { data }, size_ { size } {}
+
+    template <std::size_t N>
+    // NOLINTNEXTLINE(*-explicit-conversions, *-avoid-c-arrays)
+    constexpr Span(T (&array)[N]) : data_ { array }, size_ { N } {}
+
+    template <
+        typename C,
+        typename = std::enable_if_t<
+            !std::is_array_v<C>
+            && detail::is_span_compatible<C, T>::value>>
+    // NOLINTNEXTLINE(*-explicit-conversions)
+    constexpr Span(C& container)
+        : data_ { std::data(container) }, size_ { std::size(container) } {}
+
+    template <
+        typename C,
+        typename = std::enable_if_t<
+            !std::is_array_v<C>
+            && detail::is_span_compatible<const C, T>::value>>
+    // NOLINTNEXTLINE(*-explicit-conversions)
+    constexpr Span(const C& container)
+        : data_ { std::data(container) }, size_ { std::size(container) } {}
+
+    constexpr T* data() const {
+        return data_;
+    }
+
+    constexpr std::size_t size() const {
+        return size_;
+    }
+
+    constexpr std::size_t size_bytes() const {
+        return size_ * sizeof(T);
+    }
+
+    constexpr bool empty() const {
+        return size_ == 0;
+    }
+
+    constexpr T& operator[](std::size_t index) const {
+        return data_[index];
+    }
+
+    constexpr T& front() const {
+        return data_[0];
+    }
+
+    constexpr T& back() const {
+        return data_[size_ - 1];
+    }
+
+    constexpr iterator begin() const {
+        return data_;
+    }
+
+    constexpr iterator end() const {
+        return data_ + size_;
+    }
+
+    /// The first 'count' elements.
+    constexpr Span first(std::size_t count) const {
+        return Span { data_, count };
+    }
+
+    /// The last 'count' elements.
+    constexpr Span last(std::size_t count) const {
+        return Span { data_ + size_ - count, count };
+    }
+
+    /// The elements from 'offset' to the end.
+    constexpr Span subspan(std::size_t offset) const {
+        return Span { data_ + offset, size_ - offset };
+    }
+
+    constexpr Span subspan(std::size_t offset, std::size_t count) const {
+        return Span { data_ + offset, count };
+    }
+
+   private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+template <typename T, std::size_t N>
+// NOLINTNEXTLINE(*-avoid-c-arrays)
+Span(T (&)[N]) -> Span<T>;
+
+template <typename C>
+Span(C&) -> Span<detail::span_element_t<C>>;
+
+template <typename C>
+Span(const C&) -> Span<detail::span_element_t<const C>>;
+
+template <typename T>
+Span<const uint8_t> as_bytes(Span<T> span) {
+    return Span<const uint8_t> {
+        reinterpret_cast<const uint8_t*>(span.data()),
+        span.size_bytes(),
+    };
+}
+
+template <typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+Span<uint8_t> as_writable_bytes(Span<T> span) {
+    return Span<uint8_t> {
+        reinterpret_cast<uint8_t*>(span.data()),
+        span.size_bytes(),
+    };
+}
+
+namespace prelude {
+using ccl::Span;
+}
+
+}  // namespace ccl
+
+#endif
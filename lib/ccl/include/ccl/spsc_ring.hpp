@@ -0,0 +1,226 @@
+/// Lock-free single-producer/single-consumer ring.
+///
+/// 'SpscRing<T, N>' passes elements from exactly one producer to exactly
+/// one consumer, e.g. from an interrupt to the main loop, without disabling
+/// interrupts. Each side writes only its own index: the producer publishes
+/// elements with a release store of the write index and the consumer frees
+/// them with a release store of the read index. Each side also keeps
+/// a cached copy of the other side's index and reloads it only when the
+/// cached value does not allow the requested operation.
+///
+/// Besides single elements the ring exposes its free and filled space as
+/// contiguous regions, so a DMA transfer or a parser can work on the
+/// elements in place. A region may end at the end of the storage, the rest
+/// is available at 'offset' equal to the size of the previous region.
+/// Regions are published or freed in batches with 'commit' and 'release'.
+///
+/// 'N' must be a power of two and 'T' trivially copyable.
+///
+/// # Examples
+///
+/// ```
+/// SpscRing<uint8_t, 256> rx;
+///
+/// // Interrupt
+/// rx.try_push(USART2->RDR).expect("RX overrun");
+///
+/// // Main loop
+/// auto region = rx.read_region();
+/// std::size_t used = parser.feed(region.data, region.size);
+/// rx.release(used);
+/// ```
+
+#ifndef CCL_SPSC_RING_HPP
+#define CCL_SPSC_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+#include "capacity_error.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+template <typename T, std::size_t N>
+class SpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "T must be trivially copyable"
+    );
+
+   public:
+    struct Region {
+        T* data;
+        std::size_t size;
+    };
+
+    struct ConstRegion {
+        const T* data;
+        std::size_t size;
+    };
+
+    SpscRing() = default;
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing(SpscRing&&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    SpscRing& operator=(SpscRing&&) = delete;
+    ~SpscRing() = default;
+
+    // Producer side.
+
+    Result<Unit, CapacityError> try_push(const T& value) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (free_from(head, 1) == 0) {
+            return Err { CapacityError::Full };
+        }
+        elements_[head & mask] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return Ok { Unit {} };
+    }
+
+    /// Copies all 'count' elements or nothing.
+    Result<Unit, CapacityError> try_write(const T* data, std::size_t count) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (free_from(head, count) < count) {
+            return Err { CapacityError::Full };
+        }
+        const std::size_t offset = head & mask;
+        const std::size_t first = count < N - offset ? count : N - offset;
+        std::memcpy(&elements_[offset], data, first * sizeof(T));
+        std::memcpy(&elements_[0], data + first, (count - first) * sizeof(T));
+        head_.store(head + count, std::memory_order_release);
+        return Ok { Unit {} };
+    }
+
+    /// Contiguous free space starting 'offset' elements after the write
+    /// position.
+    Region write_region(std::size_t offset = 0) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t free = free_from(head, N);
+        if (offset >= free) {
+            return Region { nullptr, 0 };
+        }
+        const std::size_t index = (head + offset) & mask;
+        const std::size_t size = free - offset;
+        return Region {
+            &elements_[index],
+            size < N - index ? size : N - index,
+        };
+    }
+
+    /// Publishes 'count' elements written through 'write_region'.
+    void commit(std::size_t count) {
+        head_.store(
+            head_.load(std::memory_order_relaxed) + count,
+            std::memory_order_release
+        );
+    }
+
+    // Consumer side.
+
+    std::optional<T> pop() {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (available_from(tail, 1) == 0) {
+            return std::nullopt;
+        }
+        const T value = elements_[tail & mask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return value;
+    }
+
+    /// Copies up to 'count' elements and returns the number copied.
+    std::size_t read(T* data, std::size_t count) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t available = available_from(tail, count);
+        if (count > available) {
+            count = available;
+        }
+        const std::size_t offset = tail & mask;
+        const std::size_t first = count < N - offset ? count : N - offset;
+        std::memcpy(data, &elements_[offset], first * sizeof(T));
+        std::memcpy(data + first, &elements_[0], (count - first) * sizeof(T));
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Contiguous filled space starting 'offset' elements after the read
+    /// position.
+    ConstRegion read_region(std::size_t offset = 0) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t available = available_from(tail, N);
+        if (offset >= available) {
+            return ConstRegion { nullptr, 0 };
+        }
+        const std::size_t index = (tail + offset) & mask;
+        const std::size_t size = available - offset;
+        return ConstRegion {
+            &elements_[index],
+            size < N - index ? size : N - index,
+        };
+    }
+
+    /// Frees 'count' elements read through 'read_region'.
+    void release(std::size_t count) {
+        tail_.store(
+            tail_.load(std::memory_order_relaxed) + count,
+            std::memory_order_release
+        );
+    }
+
+    // Either side, the result may be outdated when it is used.
+
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire)
+               - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr std::size_t capacity() {
+        return N;
+    }
+
+   private:
+    static constexpr uint32_t mask = N - 1;
+
+    std::size_t free_from(uint32_t head, std::size_t wanted) {
+        if (N - (head - cached_tail_) < wanted) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        return N - (head - cached_tail_);
+    }
+
+    std::size_t available_from(uint32_t tail, std::size_t wanted) {
+        if (cached_head_ - tail < wanted) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        return cached_head_ - tail;
+    }
+
+    std::array<T, N> elements_ {};
+
+    // Free running counters, the index is the counter modulo N.
+    std::atomic<uint32_t> head_ { 0 };
+    std::atomic<uint32_t> tail_ { 0 };
+
+    // Producer's copy of 'tail_' and consumer's copy of 'head_'.
+    uint32_t cached_tail_ = 0;
+    uint32_t cached_head_ = 0;
+};
+
+namespace prelude {
+using ccl::SpscRing;
+}
+
+}  // namespace ccl
+
+#endif
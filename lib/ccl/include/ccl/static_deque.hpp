@@ -0,0 +1,247 @@
+/// Double-ended queue with inline storage.
+///
+/// 'StaticDeque<T, N>' is a ring of up to 'N' elements that can be pushed
+/// and popped at both ends in constant time without allocating. Pushing to
+/// a full deque fails with 'CapacityError::Full'.
+///
+/// Deques of trivial types are trivially copyable and usable in constant
+/// expressions. 'N' does not have to be a power of two.
+///
+/// The deque is not synchronized, it must not be shared with interrupts.
+///
+/// # Examples
+///
+/// ```
+/// StaticDeque<Command, 8> commands;
+///
+/// commands.try_push_back(command).expect("Command queue full");
+/// while (auto command = commands.pop_front()) { execute(*command); }
+/// ```
+
+#ifndef CCL_STATIC_DEQUE_HPP
+#define CCL_STATIC_DEQUE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "capacity_error.hpp"
+#include "inline_storage.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+namespace detail {
+
+template <typename T, std::size_t N, bool = std::is_trivial_v<T>>
+struct StaticDequeBase {
+    InlineStorage<T, N> storage_;
+    size_type_for<N> head_ = 0;
+    size_type_for<N> size_ = 0;
+
+    static constexpr std::size_t wrap(std::size_t index) {
+        return index < N ? index : index - N;
+    }
+};
+
+template <typename T, std::size_t N>
+struct StaticDequeBase<T, N, false> {
+    InlineStorage<T, N> storage_;
+    size_type_for<N> head_ = 0;
+    size_type_for<N> size_ = 0;
+
+    static constexpr std::size_t wrap(std::size_t index) {
+        return index < N ? index : index - N;
+    }
+
+    StaticDequeBase() = default;
+
+    StaticDequeBase(const StaticDequeBase& other) {
+        construct(other);
+    }
+
+    StaticDequeBase(StaticDequeBase&& other) noexcept {
+        construct(std::move(other));
+    }
+
+    // NOLINTNEXTLINE(cert-oop54-cpp)
+    StaticDequeBase& operator=(const StaticDequeBase& other) {
+        if (this != &other) {
+            clear();
+            construct(other);
+        }
+        return *this;
+    }
+
+    StaticDequeBase& operator=(StaticDequeBase&& other) noexcept {
+        if (this != &other) {
+            clear();
+            construct(std::move(other));
+        }
+        return *this;
+    }
+
+    ~StaticDequeBase() {
+        clear();
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            storage_.destroy(wrap(head_ + i));
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // The copy starts at slot 0.
+    template <typename D>
+    void construct(D&& other) {
+        for (std::size_t i = 0; i < other.size_; ++i) {
+            auto* element = other.storage_.slot(wrap(other.head_ + i));
+            if constexpr (std::is_lvalue_reference_v<D>) {
+                storage_.construct(i, *element);
+            } else {
+                storage_.construct(i, std::move(*element));
+            }
+        }
+        head_ = 0;
+        size_ = other.size_;
+    }
+};
+
+}  // namespace detail
+
+template <typename T, std::size_t N>
+class StaticDeque : detail::StaticDequeBase<T, N> {
+    static_assert(N > 0, "StaticDeque needs a non-zero capacity");
+
+    using Base = detail::StaticDequeBase<T, N>;
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    constexpr StaticDeque() = default;
+
+    constexpr Result<Unit, CapacityError> try_push_back(const T& value) {
+        return try_emplace_back(value);
+    }
+
+    constexpr Result<Unit, CapacityError> try_push_back(T&& value) {
+        return try_emplace_back(std::move(value));
+    }
+
+    constexpr Result<Unit, CapacityError> try_push_front(const T& value) {
+        return try_emplace_front(value);
+    }
+
+    constexpr Result<Unit, CapacityError> try_push_front(T&& value) {
+        return try_emplace_front(std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr Result<Unit, CapacityError> try_emplace_back(Args&&... args) {
+        if (full()) {
+            return Err { CapacityError::Full };
+        }
+        this->storage_.construct(
+            Base::wrap(this->head_ + this->size_),
+            std::forward<Args>(args)...
+        );
+        ++this->size_;
+        return Ok { Unit {} };
+    }
+
+    template <typename... Args>
+    constexpr Result<Unit, CapacityError> try_emplace_front(Args&&... args) {
+        if (full()) {
+            return Err { CapacityError::Full };
+        }
+        const std::size_t head = this->head_ == 0 ? N - 1 : this->head_ - 1;
+        this->storage_.construct(head, std::forward<Args>(args)...);
+        this->head_ = head;
+        ++this->size_;
+        return Ok { Unit {} };
+    }
+
+    constexpr std::optional<T> pop_front() {
+        if (empty()) {
+            return std::nullopt;
+        }
+        const std::size_t head = this->head_;
+        std::optional<T> value { std::move(*this->storage_.slot(head)) };
+        this->storage_.destroy(head);
+        this->head_ = Base::wrap(head + 1);
+        --this->size_;
+        return value;
+    }
+
+    constexpr std::optional<T> pop_back() {
+        if (empty()) {
+            return std::nullopt;
+        }
+        --this->size_;
+        const std::size_t tail = Base::wrap(this->head_ + this->size_);
+        std::optional<T> value { std::move(*this->storage_.slot(tail)) };
+        this->storage_.destroy(tail);
+        return value;
+    }
+
+    constexpr void clear() {
+        for (std::size_t i = 0; i < this->size_; ++i) {
+            this->storage_.destroy(Base::wrap(this->head_ + i));
+        }
+        this->head_ = 0;
+        this->size_ = 0;
+    }
+
+    /// Element at 'index' counted from the front. Not bounds checked.
+    constexpr T& operator[](std::size_t index) {
+        return *this->storage_.slot(Base::wrap(this->head_ + index));
+    }
+
+    constexpr const T& operator[](std::size_t index) const {
+        return *this->storage_.slot(Base::wrap(this->head_ + index));
+    }
+
+    constexpr T& front() {
+        return (*this)[0];
+    }
+
+    constexpr const T& front() const {
+        return (*this)[0];
+    }
+
+    constexpr T& back() {
+        return (*this)[size() - 1];
+    }
+
+    constexpr const T& back() const {
+        return (*this)[size() - 1];
+    }
+
+    constexpr std::size_t size() const {
+        return this->size_;
+    }
+
+    constexpr bool empty() const {
+        return this->size_ == 0;
+    }
+
+    constexpr bool full() const {
+        return this->size_ == N;
+    }
+
+    static constexpr std::size_t capacity() {
+        return N;
+    }
+};
+
+namespace prelude {
+using ccl::StaticDeque;
+}
+
+}  // namespace ccl
+
+#endif
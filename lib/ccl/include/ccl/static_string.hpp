@@ -0,0 +1,172 @@
+/// String with inline storage.
+///
+/// 'StaticString<N>' holds up to 'N' characters followed by a null
+/// terminator, so 'c_str' can be passed to C APIs. Appending more than fits
+/// fails with 'CapacityError::Full' and leaves the string unchanged.
+///
+/// Static strings are trivially copyable and usable in constant
+/// expressions. Initializing one from a literal that is too long is
+/// a compile error.
+///
+/// # Examples
+///
+/// ```
+/// StaticString<16> name = "obc";
+///
+/// name.try_append("-hal").expect("Name too long");
+/// uart.send(name.view());
+/// ```
+
+#ifndef CCL_STATIC_STRING_HPP
+#define CCL_STATIC_STRING_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "capacity_error.hpp"
+#include "inline_storage.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+template <std::size_t N>
+class StaticString {
+    std::array<char, N + 1> chars_ {};
+    detail::size_type_for<N> size_ = 0;
+
+   public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    constexpr StaticString() = default;
+
+    template <std::size_t M>
+    // NOLINTNEXTLINE(*-explicit-conversions, *-avoid-c-arrays)
+    constexpr StaticString(const char (&literal)[M]) {
+        static_assert(M - 1 <= N, "String literal does not fit");
+        for (std::size_t i = 0; i + 1 < M; ++i) {
+            chars_[i] = literal[i];
+        }
+        size_ = M - 1;
+    }
+
+    constexpr Result<Unit, CapacityError> try_push(char c) {
+        if (size_ == N) {
+            return Err { CapacityError::Full };
+        }
+        chars_[size_++] = c;
+        chars_[size_] = '\0';
+        return Ok { Unit {} };
+    }
+
+    /// Appends all of 'text' or nothing.
+    constexpr Result<Unit, CapacityError> try_append(std::string_view text) {
+        if (text.size() > N - size_) {
+            return Err { CapacityError::Full };
+        }
+        for (const char c : text) {
+            chars_[size_++] = c;
+        }
+        chars_[size_] = '\0';
+        return Ok { Unit {} };
+    }
+
+    /// Shortens the string to 'size' characters. Does nothing if it is
+    /// already shorter.
+    constexpr void truncate(std::size_t size) {
+        if (size < size_) {
+            size_ = static_cast<detail::size_type_for<N>>(size);
+            chars_[size_] = '\0';
+        }
+    }
+
+    constexpr void clear() {
+        truncate(0);
+    }
+
+    constexpr const char* c_str() const {
+        return chars_.data();
+    }
+
+    constexpr std::string_view view() const {
+        return std::string_view { chars_.data(), size_ };
+    }
+
+    // NOLINTNEXTLINE(*-explicit-conversions)
+    constexpr operator std::string_view() const {
+        return view();
+    }
+
+    constexpr char& operator[](std::size_t index) {
+        return chars_[index];
+    }
+
+    constexpr const char& operator[](std::size_t index) const {
+        return chars_[index];
+    }
+
+    constexpr char* data() {
+        return chars_.data();
+    }
+
+    constexpr const char* data() const {
+        return chars_.data();
+    }
+
+    constexpr iterator begin() {
+        return chars_.data();
+    }
+
+    constexpr const_iterator begin() const {
+        return chars_.data();
+    }
+
+    constexpr iterator end() {
+        return chars_.data() + size_;
+    }
+
+    constexpr const_iterator end() const {
+        return chars_.data() + size_;
+    }
+
+    constexpr std::size_t size() const {
+        return size_;
+    }
+
+    constexpr bool empty() const {
+        return size_ == 0;
+    }
+
+    constexpr bool full() const {
+        return size_ == N;
+    }
+
+    static constexpr std::size_t capacity() {
+        return N;
+    }
+
+    friend constexpr bool operator==(
+        const StaticString& lhs,
+        std::string_view rhs
+    ) {
+        return lhs.view() == rhs;
+    }
+
+    friend constexpr bool operator!=(
+        const StaticString& lhs,
+        std::string_view rhs
+    ) {
+        return lhs.view() != rhs;
+    }
+};
+
+namespace prelude {
+using ccl::StaticString;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,243 @@
+/// Vector with inline storage.
+///
+/// 'StaticVector<T, N>' holds up to 'N' elements in place, it never
+/// allocates. Adding an element to a full vector fails with
+/// 'CapacityError::Full' instead of growing.
+///
+/// Vectors of trivial types are trivially copyable and usable in constant
+/// expressions. The size is stored in the smallest type that fits 'N'.
+///
+/// Indexing is not bounds checked.
+///
+/// # Examples
+///
+/// ```
+/// StaticVector<Reading, 16> readings;
+///
+/// readings.try_push(sensor.read()).expect("Too many readings");
+/// for (const Reading& reading : readings) { ... }
+/// ```
+
+#ifndef CCL_STATIC_VECTOR_HPP
+#define CCL_STATIC_VECTOR_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "capacity_error.hpp"
+#include "inline_storage.hpp"
+#include "panic.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+namespace detail {
+
+template <typename T, std::size_t N, bool = std::is_trivial_v<T>>
+struct StaticVectorBase {
+    InlineStorage<T, N> storage_;
+    size_type_for<N> size_ = 0;
+};
+
+template <typename T, std::size_t N>
+struct StaticVectorBase<T, N, false> {
+    InlineStorage<T, N> storage_;
+    size_type_for<N> size_ = 0;
+
+    StaticVectorBase() = default;
+
+    StaticVectorBase(const StaticVectorBase& other) {
+        construct(other);
+    }
+
+    StaticVectorBase(StaticVectorBase&& other) noexcept {
+        construct(std::move(other));
+    }
+
+    // NOLINTNEXTLINE(cert-oop54-cpp)
+    StaticVectorBase& operator=(const StaticVectorBase& other) {
+        if (this != &other) {
+            clear();
+            construct(other);
+        }
+        return *this;
+    }
+
+    StaticVectorBase& operator=(StaticVectorBase&& other) noexcept {
+        if (this != &other) {
+            clear();
+            construct(std::move(other));
+        }
+        return *this;
+    }
+
+    ~StaticVectorBase() {
+        clear();
+    }
+
+    void clear() {
+        while (size_ > 0) {
+            storage_.destroy(--size_);
+        }
+    }
+
+    template <typename V>
+    void construct(V&& other) {
+        for (std::size_t i = 0; i < other.size_; ++i) {
+            if constexpr (std::is_lvalue_reference_v<V>) {
+                storage_.construct(i, *other.storage_.slot(i));
+            } else {
+                storage_.construct(i, std::move(*other.storage_.slot(i)));
+            }
+        }
+        size_ = other.size_;
+    }
+};
+
+}  // namespace detail
+
+template <typename T, std::size_t N>
+class StaticVector : detail::StaticVectorBase<T, N> {
+    static_assert(N > 0, "StaticVector needs a non-zero capacity");
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr StaticVector() = default;
+
+    /// Panics if there are more than 'N' values.
+    constexpr StaticVector(std::initializer_list<T> values) {
+        if (values.size() > N) {
+            panic("StaticVector capacity exceeded");
+        }
+        for (const T& value : values) {
+            this->storage_.construct(this->size_++, value);
+        }
+    }
+
+    constexpr Result<Unit, CapacityError> try_push(const T& value) {
+        return try_emplace(value);
+    }
+
+    constexpr Result<Unit, CapacityError> try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr Result<Unit, CapacityError> try_emplace(Args&&... args) {
+        if (full()) {
+            return Err { CapacityError::Full };
+        }
+        this->storage_.construct(this->size_, std::forward<Args>(args)...);
+        ++this->size_;
+        return Ok { Unit {} };
+    }
+
+    /// Removes and returns the last element.
+    constexpr std::optional<T> pop() {
+        if (empty()) {
+            return std::nullopt;
+        }
+        --this->size_;
+        T* last = this->storage_.slot(this->size_);
+        std::optional<T> value { std::move(*last) };
+        this->storage_.destroy(this->size_);
+        return value;
+    }
+
+    /// Removes the element at 'pos' and shifts the following ones. Returns
+    /// an iterator to the element after the removed one.
+    constexpr iterator erase(const_iterator pos) {
+        const auto index = static_cast<std::size_t>(pos - begin());
+        for (std::size_t i = index; i + 1 < size(); ++i) {
+            *this->storage_.slot(i) = std::move(*this->storage_.slot(i + 1));
+        }
+        --this->size_;
+        this->storage_.destroy(this->size_);
+        return begin() + index;
+    }
+
+    constexpr void clear() {
+        while (this->size_ > 0) {
+            this->storage_.destroy(--this->size_);
+        }
+    }
+
+    constexpr T& operator[](std::size_t index) {
+        return *this->storage_.slot(index);
+    }
+
+    constexpr const T& operator[](std::size_t index) const {
+        return *this->storage_.slot(index);
+    }
+
+    constexpr T& front() {
+        return (*this)[0];
+    }
+
+    constexpr const T& front() const {
+        return (*this)[0];
+    }
+
+    constexpr T& back() {
+        return (*this)[size() - 1];
+    }
+
+    constexpr const T& back() const {
+        return (*this)[size() - 1];
+    }
+
+    constexpr T* data() {
+        return this->storage_.slot(0);
+    }
+
+    constexpr const T* data() const {
+        return this->storage_.slot(0);
+    }
+
+    constexpr iterator begin() {
+        return data();
+    }
+
+    constexpr const_iterator begin() const {
+        return data();
+    }
+
+    constexpr iterator end() {
+        return data() + size();
+    }
+
+    constexpr const_iterator end() const {
+        return data() + size();
+    }
+
+    constexpr std::size_t size() const {
+        return this->size_;
+    }
+
+    constexpr bool empty() const {
+        return this->size_ == 0;
+    }
+
+    constexpr bool full() const {
+        return this->size_ == N;
+    }
+
+    static constexpr std::size_t capacity() {
+        return N;
+    }
+};
+
+namespace prelude {
+using ccl::StaticVector;
+}
+
+}  // namespace ccl
+
+#endif
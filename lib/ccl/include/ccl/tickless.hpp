@@ -0,0 +1,136 @@
+/// Tickless idle decisions.
+///
+/// A tickless idle layer stops the periodic tick while nothing is due and
+/// sleeps in a low-power mode until the next deadline, woken by a low-power
+/// counter. This header holds the platform independent part:
+///
+/// * 'plan_idle' decides how to wait for a deadline: not at all, in a light
+///   sleep that keeps the tick running, or in a deep stop with the tick
+///   suspended. Stopping costs a fixed wakeup time, so it only pays off for
+///   waits of at least 'IdlePolicy::min_stop_ticks'. The stop ends
+///   'wake_margin_ticks' early so that the wakeup latency does not delay
+///   the deadline, the rest is spent in a light sleep.
+/// * 'TickCompensator' converts the counts of the low-power counter into
+///   ticks. The counter frequency is rarely a multiple of the tick
+///   frequency, e.g. 32768 Hz and 1 kHz, so the fraction of a tick left over
+///   after each stop is carried over to the next one instead of being lost.
+///   The time elapsed since the last tick when the tick is suspended is
+///   added the same way. The tick count therefore does not drift from the
+///   counter, however many stops there are.
+///
+/// # Examples
+///
+/// ```
+/// constexpr IdlePolicy policy { 5, 1900, 1 };
+/// TickCompensator compensator { 32768, 1000 };
+///
+/// const IdleDecision decision = plan_idle(deadline - now, can_stop, policy);
+/// if (decision.mode == IdleMode::Stop) {
+///     compensator.add_fraction(systick_elapsed, systick_period);
+///     const uint32_t counts = compensator.counts_for(decision.ticks);
+///     ...
+///     ticks += compensator.elapsed_ticks(counted);
+/// }
+/// ```
+
+#ifndef CCL_TICKLESS_HPP
+#define CCL_TICKLESS_HPP
+
+#include <cstdint>
+
+namespace ccl {
+
+struct IdlePolicy {
+    /// Shortest stop worth its wakeup time.
+    uint32_t min_stop_ticks;
+    /// Longest stop the wakeup counter can time.
+    uint32_t max_stop_ticks;
+    /// Ticks before the deadline at which a stop ends.
+    uint32_t wake_margin_ticks;
+};
+
+enum class IdleMode : uint8_t {
+    /// The deadline has passed.
+    Run,
+    /// Sleep until the next interrupt, the tick keeps running.
+    Sleep,
+    /// Suspend the tick and stop for 'IdleDecision::ticks'.
+    Stop,
+};
+
+struct IdleDecision {
+    IdleMode mode;
+    uint32_t ticks;
+};
+
+/// Decides how to wait 'remaining' ticks. 'stop_allowed' is false while
+/// a peripheral that does not work in the stop mode is in use.
+constexpr IdleDecision plan_idle(
+    uint32_t remaining,
+    bool stop_allowed,
+    const IdlePolicy& policy
+) {
+    if (remaining == 0) {
+        return IdleDecision { IdleMode::Run, 0 };
+    }
+    if (!stop_allowed
+        || remaining < policy.min_stop_ticks + policy.wake_margin_ticks) {
+        return IdleDecision { IdleMode::Sleep, remaining };
+    }
+    const uint32_t ticks = remaining - policy.wake_margin_ticks;
+    return IdleDecision {
+        IdleMode::Stop,
+        ticks < policy.max_stop_ticks ? ticks : policy.max_stop_ticks,
+    };
+}
+
+class TickCompensator {
+   public:
+    constexpr TickCompensator(uint32_t counter_hz, uint32_t tick_hz)
+        : counter_hz_ { counter_hz }, tick_hz_ { tick_hz } {}
+
+    /// Adds 'part / whole' of a tick that has elapsed but was not counted.
+    void add_fraction(uint32_t part, uint32_t whole) {
+        fraction_ += uint64_t { part } * counter_hz_ / whole;
+    }
+
+    /// Counts after which 'ticks' ticks have elapsed, including the carried
+    /// fraction. At least one.
+    uint32_t counts_for(uint32_t ticks) const {
+        const uint64_t needed = uint64_t { ticks } * counter_hz_;
+        if (needed <= fraction_) {
+            return 1;
+        }
+        return static_cast<uint32_t>(
+            (needed - fraction_ + tick_hz_ - 1) / tick_hz_
+        );
+    }
+
+    /// Converts 'counts' elapsed counts into whole ticks and carries the
+    /// remaining fraction of a tick over.
+    uint32_t elapsed_ticks(uint32_t counts) {
+        const uint64_t total = fraction_ + uint64_t { counts } * tick_hz_;
+        fraction_ = total % counter_hz_;
+        return static_cast<uint32_t>(total / counter_hz_);
+    }
+
+   private:
+    uint32_t counter_hz_;
+    uint32_t tick_hz_;
+    // Elapsed time not yet counted as ticks, in 1/counter_hz ticks.
+    uint64_t fraction_ = 0;
+};
+
+namespace prelude {
+
+using ccl::IdleDecision;
+using ccl::IdleMode;
+using ccl::IdlePolicy;
+using ccl::plan_idle;
+using ccl::TickCompensator;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
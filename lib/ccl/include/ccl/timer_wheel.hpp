@@ -0,0 +1,313 @@
+/// Hierarchical timer wheel.
+///
+/// 'TimerWheel<Lock>' runs one-shot and periodic software timers off
+/// a periodic tick, typically SysTick. Timers are intrusive: a 'Timer'
+/// holds its own links, so starting one never allocates and the number of
+/// timers is not limited.
+///
+/// The wheel has 4 levels of 64 slots. Level 0 holds timers expiring within
+/// the next 64 ticks, one slot per tick, each further level covers 64 times
+/// the range of the previous one. Starting and cancelling a timer is
+/// constant time. When the ticks wrap around a slot of a higher level, the
+/// timers in it are moved to lower levels. Delays longer than the range of
+/// the wheel, 2^24 ticks, are supported by moving them again, up to 2^31
+/// ticks.
+///
+/// A timer's callback runs either directly in 'tick', i.e. in the
+/// interrupt, or deferred to 'run_deferred', called from the main loop.
+/// Deferred callbacks run in expiry order.
+///
+/// For tickless idle, 'ticks_until_next' tells how long the tick may be
+/// suspended. The missed ticks are then caught up by calling 'tick' once
+/// for each of them. 'has_deferred' tells the main loop that it has
+/// callbacks to run instead of idling.
+///
+/// 'Lock' is a type whose lifetime is a critical section with respect to
+/// the interrupt calling 'tick', e.g. one that masks interrupts. On the
+/// host a type without effect can be used. Callbacks run without the lock
+/// held and may start or cancel any timer.
+///
+/// # Examples
+///
+/// ```
+/// TimerWheel<InterruptLock> timers;
+/// Timer retry { [] { resend(); } };
+///
+/// void SysTick_Handler() { timers.tick(); }
+///
+/// timers.start(retry, 50);
+/// while (true) { timers.run_deferred(); }
+/// ```
+
+#ifndef CCL_TIMER_WHEEL_HPP
+#define CCL_TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "inplace_function.hpp"
+
+namespace ccl {
+
+template <typename Lock>
+class TimerWheel;
+
+class Timer {
+   public:
+    using Callback = InplaceFunction<void()>;
+
+    enum class Dispatch : uint8_t {
+        /// In 'TimerWheel::tick'.
+        Interrupt,
+        /// In 'TimerWheel::run_deferred'.
+        Deferred,
+    };
+
+    explicit Timer(Callback callback, Dispatch dispatch = Dispatch::Deferred)
+        : callback_ { callback }, dispatch_ { dispatch } {}
+
+    Timer(const Timer&) = delete;
+    Timer(Timer&&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    Timer& operator=(Timer&&) = delete;
+    ~Timer() = default;
+
+    /// True while the timer is started or its deferred callback is pending.
+    bool is_active() const {
+        return state_ != State::Idle;
+    }
+
+   private:
+    template <typename Lock>
+    friend class TimerWheel;
+
+    enum class State : uint8_t { Idle, Armed, Pending };
+
+    Timer* next_ = nullptr;
+    // Link that points to this timer, allows unlinking without a search.
+    Timer** pprev_ = nullptr;
+    uint32_t expiry_ = 0;
+    uint32_t period_ = 0;
+    Callback callback_;
+    Dispatch dispatch_;
+    State state_ = State::Idle;
+};
+
+template <typename Lock>
+class TimerWheel {
+   public:
+    TimerWheel() = default;
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+    ~TimerWheel() = default;
+
+    /// Starts 'timer' to expire 'delay' ticks from now, at least one, and
+    /// then every 'period' ticks if 'period' is not zero. Restarts the timer
+    /// if it is active.
+    void start(Timer& timer, uint32_t delay, uint32_t period = 0) {
+        const Lock lock;
+        unlink(timer);
+        timer.expiry_ = now_ + (delay > 0 ? delay : 1);
+        timer.period_ = period;
+        arm(timer);
+    }
+
+    /// Stops 'timer' and drops its pending deferred callback. Does nothing
+    /// if the timer is not active.
+    void cancel(Timer& timer) {
+        const Lock lock;
+        unlink(timer);
+    }
+
+    /// Advances the time by one tick and dispatches expired timers.
+    void tick() {
+        {
+            const Lock lock;
+            ++now_;
+            cascade();
+        }
+        while (true) {
+            Timer::Callback callback;
+            {
+                const Lock lock;
+                Timer* timer = slots_[0][now_ & slot_mask];
+                if (timer == nullptr) {
+                    break;
+                }
+                unlink(*timer);
+                if (timer->dispatch_ == Timer::Dispatch::Deferred) {
+                    append_pending(*timer);
+                    continue;
+                }
+                if (timer->period_ != 0) {
+                    timer->expiry_ += timer->period_;
+                    arm(*timer);
+                }
+                callback = timer->callback_;
+            }
+            callback();
+        }
+    }
+
+    /// Runs the callbacks of expired deferred timers. Returns the number of
+    /// callbacks run.
+    std::size_t run_deferred() {
+        std::size_t count = 0;
+        while (true) {
+            Timer::Callback callback;
+            {
+                const Lock lock;
+                Timer* timer = pending_head_;
+                if (timer == nullptr) {
+                    break;
+                }
+                unlink(*timer);
+                if (timer->period_ != 0) {
+                    // Keep the phase, but never schedule into the past.
+                    timer->expiry_ += timer->period_;
+                    if (static_cast<int32_t>(timer->expiry_ - now_) <= 0) {
+                        timer->expiry_ = now_ + 1;
+                    }
+                    arm(*timer);
+                }
+                callback = timer->callback_;
+            }
+            callback();
+            ++count;
+        }
+        return count;
+    }
+
+    /// Whether expired deferred timers wait for 'run_deferred'.
+    bool has_deferred() const {
+        const Lock lock;
+        return pending_head_ != nullptr;
+    }
+
+    /// Ticks, at most 'limit', until the next tick that dispatches or moves
+    /// a timer. Timers in higher levels count at the tick that moves them
+    /// down, so the result may be shorter than the time to the next expiry
+    /// but never longer. Pending deferred callbacks do not need ticks and
+    /// are not taken into account.
+    uint32_t ticks_until_next(uint32_t limit) const {
+        const Lock lock;
+        uint32_t ticks = limit;
+        for (unsigned level = 0; level < level_count; ++level) {
+            const unsigned shift = slot_bits * level;
+            const uint32_t base = now_ >> shift;
+            for (uint32_t offset = 1; offset <= slot_count; ++offset) {
+                const uint32_t distance = ((base + offset) << shift) - now_;
+                if (distance >= ticks) {
+                    break;
+                }
+                if (slots_[level][(base + offset) & slot_mask] != nullptr) {
+                    ticks = distance;
+                    break;
+                }
+            }
+        }
+        return ticks;
+    }
+
+    /// Ticks since construction.
+    uint32_t now() const {
+        return now_;
+    }
+
+   private:
+    static constexpr unsigned slot_bits = 6;
+    static constexpr unsigned slot_count = 1U << slot_bits;
+    static constexpr uint32_t slot_mask = slot_count - 1;
+    static constexpr unsigned level_count = 4;
+    static constexpr uint32_t range = 1U << (slot_bits * level_count);
+
+    // Inserts an armed timer into the slot for its expiry. Expiries in the
+    // past are put into the current slot of level 0, which is dispatched
+    // later in the same 'tick' while cascading and otherwise only after
+    // a full turn of level 0. 'start' and 'run_deferred' never arm such
+    // timers, 'cascade' does for timers that expire this tick.
+    void arm(Timer& timer) {
+        const auto delta = static_cast<int32_t>(timer.expiry_ - now_);
+        uint32_t target = delta > 0 ? timer.expiry_ : now_;
+        if (delta >= static_cast<int32_t>(range)) {
+            target = now_ + range - 1;
+        }
+        const uint32_t distance = target - now_;
+        unsigned level = 0;
+        while (level + 1 < level_count
+               && distance >= (1U << (slot_bits * (level + 1)))) {
+            ++level;
+        }
+        const uint32_t slot = (target >> (slot_bits * level)) & slot_mask;
+        push(slots_[level][slot], timer);
+        timer.state_ = Timer::State::Armed;
+    }
+
+    // Moves the timers of each higher level slot whose range starts now to
+    // lower levels.
+    void cascade() {
+        for (unsigned level = 1; level < level_count; ++level) {
+            const unsigned shift = slot_bits * level;
+            if ((now_ & ((1U << shift) - 1)) != 0) {
+                break;
+            }
+            Timer*& head = slots_[level][(now_ >> shift) & slot_mask];
+            while (head != nullptr) {
+                Timer* timer = head;
+                unlink(*timer);
+                arm(*timer);
+            }
+        }
+    }
+
+    static void push(Timer*& head, Timer& timer) {
+        timer.next_ = head;
+        timer.pprev_ = &head;
+        if (head != nullptr) {
+            head->pprev_ = &timer.next_;
+        }
+        head = &timer;
+    }
+
+    void append_pending(Timer& timer) {
+        timer.next_ = nullptr;
+        timer.pprev_ = pending_tail_;
+        *pending_tail_ = &timer;
+        pending_tail_ = &timer.next_;
+        timer.state_ = Timer::State::Pending;
+    }
+
+    void unlink(Timer& timer) {
+        if (timer.state_ == Timer::State::Idle) {
+            return;
+        }
+        *timer.pprev_ = timer.next_;
+        if (timer.next_ != nullptr) {
+            timer.next_->pprev_ = timer.pprev_;
+        } else if (timer.state_ == Timer::State::Pending) {
+            pending_tail_ = timer.pprev_;
+        }
+        timer.next_ = nullptr;
+        timer.pprev_ = nullptr;
+        timer.state_ = Timer::State::Idle;
+    }
+
+    Timer* slots_[level_count][slot_count] {};
+    Timer* pending_head_ = nullptr;
+    Timer** pending_tail_ = &pending_head_;
+    uint32_t now_ = 0;
+};
+
+namespace prelude {
+
+using ccl::Timer;
+using ccl::TimerWheel;
+
+}  // namespace prelude
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,137 @@
+/// Two-level segregated fit allocator.
+///
+/// 'Tlsf' manages a caller-provided memory region and allocates and frees
+/// blocks in constant time, independent of the number and size of blocks
+/// in use. Free blocks are kept in lists segregated by size: a first level
+/// per power of two and 16 second-level lists splitting each power of two
+/// linearly. Two bitmaps record which lists are non-empty, so finding
+/// a large enough block takes two find-first-set operations. Freed blocks
+/// are merged with free physical neighbors immediately.
+///
+/// Each block carries a header of two words. All sizes are rounded up to
+/// 8 bytes and all blocks are 8-byte aligned.
+///
+/// 'Tlsf' is not synchronized, callers sharing it between contexts must
+/// provide mutual exclusion.
+///
+/// # Examples
+///
+/// ```
+/// unsigned char region[8192];
+/// Tlsf heap { region, sizeof(region) };
+///
+/// void* p = heap.try_allocate(100).expect("Out of heap memory");
+/// heap.free(p);
+/// ```
+
+#ifndef CCL_TLSF_HPP
+#define CCL_TLSF_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "capacity_error.hpp"
+#include "result.hpp"
+
+namespace ccl {
+
+class Tlsf {
+   public:
+    struct Stats {
+        /// Bytes in allocated blocks, excluding headers.
+        std::size_t used;
+        /// Highest value of 'used' so far.
+        std::size_t peak;
+        /// Bytes in free blocks, excluding headers.
+        std::size_t free;
+        std::size_t free_blocks;
+        /// Size of the largest free block. 'free - largest_free' is the
+        /// memory lost to fragmentation. Only the first 'stats_scan_max'
+        /// blocks of the list of the largest blocks are compared, so with
+        /// more blocks in it the value may be up to 1/16 too small.
+        /// Requests are served from the list above their size, so one of
+        /// exactly 'largest_free' bytes may still fail, one of 1/8 less
+        /// always succeeds.
+        std::size_t largest_free;
+    };
+
+    Tlsf(void* region, std::size_t size);
+
+    Tlsf(const Tlsf&) = delete;
+    Tlsf(Tlsf&&) = delete;
+    Tlsf& operator=(const Tlsf&) = delete;
+    Tlsf& operator=(Tlsf&&) = delete;
+    ~Tlsf() = default;
+
+    /// Allocates at least 'size' bytes aligned to 'alignment', which must
+    /// be a power of two.
+    Result<void*, CapacityError> try_allocate(
+        std::size_t size,
+        std::size_t alignment = alignment_min
+    );
+
+    /// Frees a block returned by 'try_allocate', null is ignored.
+    void free(void* ptr);
+
+    /// Number of bytes usable in an allocated block, at least the size
+    /// requested.
+    static std::size_t usable_size(const void* ptr);
+
+    /// Scans at most 'stats_scan_max' blocks of one free list to find the
+    /// largest free block, all other statistics are maintained on the fly.
+    /// Takes constant time, so it may be called with interrupts masked.
+    Stats stats() const;
+
+    static constexpr std::size_t alignment_min = 8;
+
+    /// Free blocks 'stats' looks at to find the largest one.
+    static constexpr std::size_t stats_scan_max = 8;
+
+    /// Largest block, larger regions are only used up to this size.
+    static constexpr std::size_t block_size_max = std::size_t { 1 } << 24;
+
+   private:
+    struct Block;
+
+    static constexpr unsigned sl_count_log2 = 4;
+    static constexpr unsigned sl_count = 1U << sl_count_log2;
+    static constexpr unsigned fl_shift = sl_count_log2 + 3;
+    // Lists 1 and up hold one power of two each, list 0 all smaller sizes.
+    // Searches round up past 'block_size_max', hence one more list.
+    static constexpr unsigned fl_count = 24 - fl_shift + 2;
+    static constexpr std::size_t small_block = std::size_t { 1 } << fl_shift;
+
+    struct Index {
+        unsigned fl;
+        unsigned sl;
+    };
+
+    static Index mapping_insert(std::size_t size);
+    static Index mapping_search(std::size_t size);
+
+    Block* find_free(Index& index) const;
+    void insert_free(Block* block);
+    void remove_free(Block* block, Index index);
+    void remove_free(Block* block);
+
+    Block* split(Block* block, std::size_t size);
+    Block* merge_prev(Block* block);
+    void merge_next(Block* block);
+
+    uint32_t fl_bitmap_ = 0;
+    uint32_t sl_bitmap_[fl_count] {};
+    Block* free_lists_[fl_count][sl_count] {};
+
+    std::size_t used_ = 0;
+    std::size_t peak_ = 0;
+    std::size_t free_ = 0;
+    std::size_t free_blocks_ = 0;
+};
+
+namespace prelude {
+using ccl::Tlsf;
+}
+
+}  // namespace ccl
+
+#endif
@@ -0,0 +1,67 @@
+/// Error propagation for 'Result'.
+///
+/// 'CCL_TRY(expr)' evaluates 'expr', which must be a Result. If it holds
+/// a value the macro evaluates to that value, otherwise the enclosing
+/// function returns the error. The error is converted to the error type of
+/// the enclosing function if it is implicitly convertible.
+///
+/// 'CCL_TRY_MAP_ERR(expr, f)' works the same but passes the error through
+/// 'f' before returning it, which allows converting between unrelated
+/// error types.
+///
+/// Both macros use GCC statement expressions and compile to the same
+/// branch as a hand-written 'is_err' check.
+///
+/// # Examples
+///
+/// ```
+/// Result<uint8_t, HAL_StatusTypeDef> read_register(uint8_t reg);
+///
+/// Result<uint16_t, SensorError> read_sample() {
+///     const auto to_sensor_error = [](HAL_StatusTypeDef) {
+///         return SensorError::Bus;
+///     };
+///     const uint8_t high =
+///         CCL_TRY_MAP_ERR(read_register(DATA_HIGH), to_sensor_error);
+///     const uint8_t low =
+///         CCL_TRY_MAP_ERR(read_register(DATA_LOW), to_sensor_error);
+///     return Ok { static_cast<uint16_t>(high << 8 | low) };
+/// }
+/// ```
+
+#ifndef CCL_TRY_HPP
+#define CCL_TRY_HPP
+
+#include <utility>
+
+#include "branch_prediction.hpp"
+#include "result.hpp"
+
+namespace ccl::detail {
+
+struct Identity {
+    template <typename T>
+    constexpr T&& operator()(T&& t) const {
+        return std::forward<T>(t);
+    }
+};
+
+}  // namespace ccl::detail
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CCL_TRY_MAP_ERR(expr, f)                                          \
+    __extension__({                                                       \
+        auto&& ccl_try_result_ = (expr);                                  \
+        using CclTryResult = decltype(ccl_try_result_);                   \
+        if (CCL_UNLIKELY(ccl_try_result_.is_err())) {                     \
+            return ::ccl::Err { (f)(                                      \
+                std::forward<CclTryResult>(ccl_try_result_).unwrap_err()  \
+            ) };                                                          \
+        }                                                                 \
+        std::forward<CclTryResult>(ccl_try_result_).unwrap();             \
+    })
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CCL_TRY(expr) CCL_TRY_MAP_ERR(expr, ::ccl::detail::Identity {})
+
+#endif
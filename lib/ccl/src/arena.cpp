@@ -0,0 +1,27 @@
+#include "ccl/arena.hpp"
+
+#include <cstdint>
+
+namespace ccl {
+
+Result<void*, CapacityError> Arena::try_allocate(
+    std::size_t size,
+    std::size_t alignment
+) {
+    // Align the address, not the offset, the buffer itself may be
+    // less aligned than requested.
+    const auto base = reinterpret_cast<uintptr_t>(buffer_);
+    const uintptr_t aligned =
+        (base + offset_ + alignment - 1) & ~(uintptr_t { alignment } - 1);
+    const std::size_t start = aligned - base;
+    if (start > size_ || size > size_ - start) {
+        return Err { CapacityError::Full };
+    }
+    offset_ = start + size;
+    if (offset_ > high_water_) {
+        high_water_ = offset_;
+    }
+    return Ok { static_cast<void*>(buffer_ + start) };
+}
+
+}  // namespace ccl
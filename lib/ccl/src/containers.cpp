@@ -0,0 +1,105 @@
+// Compile-time checks of the fixed-capacity containers.
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "ccl/static_deque.hpp"
+#include "ccl/static_string.hpp"
+#include "ccl/static_vector.hpp"
+
+namespace ccl {
+
+namespace {
+
+constexpr StaticVector<uint32_t, 4> squares(uint32_t count) {
+    StaticVector<uint32_t, 4> values;
+    for (uint32_t i = 1; i <= count; ++i) {
+        if (values.try_push(i * i).is_err()) {
+            break;
+        }
+    }
+    return values;
+}
+
+constexpr uint32_t sum(const StaticVector<uint32_t, 4>& values) {
+    uint32_t total = 0;
+    for (const uint32_t value : values) {
+        total += value;
+    }
+    return total;
+}
+
+constexpr StaticVector<uint32_t, 4> without_first(uint32_t count) {
+    StaticVector<uint32_t, 4> values = squares(count);
+    values.erase(values.begin());
+    return values;
+}
+
+constexpr uint32_t rotate(uint32_t pushes) {
+    StaticDeque<uint8_t, 3> deque;
+    uint32_t popped = 0;
+    for (uint32_t i = 0; i < pushes; ++i) {
+        if (deque.full()) {
+            popped = popped * 10 + deque.pop_front().value();
+        }
+        deque.try_push_back(static_cast<uint8_t>(i + 1)).unwrap();
+    }
+    deque.try_push_front(9).unwrap_err();
+    return popped * 10 + deque.back();
+}
+
+// Non-trivial element type, copies and moves of the containers must build
+// for it as well.
+struct Tracked {
+    Tracked() = default;
+    Tracked(const Tracked& other) : value { other.value } {}
+    Tracked(Tracked&& other) noexcept : value { other.value } {}
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+    ~Tracked() {}
+
+    uint32_t value = 0;
+};
+
+[[maybe_unused]] void copy_and_move_non_trivial() {
+    StaticVector<Tracked, 2> vector;
+    vector.try_emplace().unwrap();
+    const StaticVector<Tracked, 2> vector_copy { vector };
+    StaticVector<Tracked, 2> vector_moved { std::move(vector) };
+    vector_moved = vector_copy;
+
+    StaticDeque<Tracked, 2> deque;
+    deque.try_emplace_back().unwrap();
+    const StaticDeque<Tracked, 2> deque_copy { deque };
+    StaticDeque<Tracked, 2> deque_moved { std::move(deque) };
+    deque_moved = deque_copy;
+}
+
+constexpr StaticString<8> greeting() {
+    StaticString<8> text = "obc";
+    text.try_append("-hal").unwrap();
+    return text;
+}
+
+}  // namespace
+
+static_assert(sizeof(Result<Unit, CapacityError>) == 1);
+
+static_assert(sizeof(StaticVector<uint8_t, 15>) == 16);
+static_assert(std::is_trivially_copyable_v<StaticVector<uint32_t, 4>>);
+static_assert(std::is_trivially_copyable_v<StaticDeque<uint32_t, 4>>);
+static_assert(std::is_trivially_copyable_v<StaticString<8>>);
+static_assert(!std::is_trivially_copyable_v<StaticVector<Tracked, 2>>);
+static_assert(!std::is_trivially_copyable_v<StaticDeque<Tracked, 2>>);
+
+static_assert(squares(3).size() == 3);
+static_assert(squares(9).full());
+static_assert(sum(squares(3)) == 14);
+static_assert(sum(without_first(3)) == 13);
+static_assert(squares(2).back() == 4);
+static_assert(rotate(5) == 125);
+static_assert(greeting() == "obc-hal");
+static_assert(greeting().try_append("++").is_err());
+
+}  // namespace ccl
@@ -0,0 +1,7 @@
+#include "ccl/log.hpp"
+
+namespace ccl {
+
+LogBuffer<CCL_LOG_CAPACITY> log_buffer;
+
+}  // namespace ccl
@@ -2,8 +2,13 @@
 
 namespace ccl {
 
+__attribute__((weak)) void panic_hook(
+    std::string_view /*msg*/,
+    SourceLocation /*loc*/
+) {}
+
 void panic(std::string_view msg, SourceLocation loc) {
-    // TODO
+    panic_hook(msg, loc);
     while (true) {}
 }
 
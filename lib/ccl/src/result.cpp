@@ -0,0 +1,79 @@
+// Compile-time checks of the Result layouts and constant evaluation.
+
+#include "ccl/result.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+#include "ccl/non_null.hpp"
+
+namespace ccl {
+
+namespace {
+
+enum class SmallError : uint8_t { A = 1, B };
+
+enum class NoNicheError : uint8_t { A, B };
+
+enum class ParseError : uint8_t { Empty = 1, InvalidDigit, Overflow };
+
+constexpr Result<uint32_t, ParseError> parse_u32(std::string_view text) {
+    if (text.empty()) {
+        return Err { ParseError::Empty };
+    }
+    uint32_t value = 0;
+    for (const char c : text) {
+        if (c < '0' || c > '9') {
+            return Err { ParseError::InvalidDigit };
+        }
+        const auto digit = static_cast<uint32_t>(c - '0');
+        if (value > (UINT32_MAX - digit) / 10) {
+            return Err { ParseError::Overflow };
+        }
+        value = value * 10 + digit;
+    }
+    return Ok { value };
+}
+
+constexpr Result<uint32_t, ParseError> uart_divisor(
+    uint32_t clock,
+    std::string_view baud
+) {
+    return parse_u32(baud).and_then(
+        [clock](uint32_t rate) -> Result<uint32_t, ParseError> {
+            if (rate == 0) {
+                return Err { ParseError::InvalidDigit };
+            }
+            return Ok { (clock + rate / 2) / rate };
+        }
+    );
+}
+
+}  // namespace
+
+template <>
+struct Niche<SmallError> {
+    static constexpr SmallError value = SmallError { 0 };
+};
+
+static_assert(sizeof(Result<Unit, SmallError>) == sizeof(SmallError));
+static_assert(sizeof(Result<Unit, NoNicheError>) == 2);
+static_assert(sizeof(Result<NonNull<int>, Unit>) == sizeof(int*));
+static_assert(sizeof(Result<int*, Unit>) == 2 * sizeof(int*));
+static_assert(sizeof(Result<uint32_t, SmallError>) == 2 * sizeof(uint32_t));
+
+static_assert(std::is_trivially_copyable_v<Result<Unit, SmallError>>);
+static_assert(std::is_trivially_copyable_v<Result<NonNull<int>, Unit>>);
+
+static_assert(parse_u32("115200").unwrap() == 115200);
+static_assert(parse_u32("").unwrap_err() == ParseError::Empty);
+static_assert(parse_u32("12a").unwrap_err() == ParseError::InvalidDigit);
+static_assert(parse_u32("4294967296").unwrap_err() == ParseError::Overflow);
+static_assert(parse_u32("x").value_or(7) == 7);
+static_assert(parse_u32("42").map([](uint32_t v) { return v * 2; }).unwrap()
+              == 84);
+static_assert(uart_divisor(80'000'000, "115200").unwrap() == 694);
+static_assert(uart_divisor(80'000'000, "0").is_err());
+static_assert(!parse_u32("1").err().has_value());
+
+}  // namespace ccl
@@ -0,0 +1,329 @@
+#include "ccl/tlsf.hpp"
+
+#include "ccl/panic.hpp"
+
+namespace ccl {
+
+namespace {
+
+constexpr std::size_t header = 2 * sizeof(void*);
+constexpr std::size_t payload_min = 2 * sizeof(void*);
+
+static_assert(header % Tlsf::alignment_min == 0);
+
+constexpr uintptr_t align_down(uintptr_t value, std::size_t alignment) {
+    return value & ~(uintptr_t { alignment } - 1);
+}
+
+constexpr uintptr_t align_up(uintptr_t value, std::size_t alignment) {
+    return align_down(value + alignment - 1, alignment);
+}
+
+unsigned fls(std::size_t value) {
+    return 63U - static_cast<unsigned>(__builtin_clzll(value));
+}
+
+unsigned ffs(uint32_t value) {
+    return static_cast<unsigned>(__builtin_ctz(value));
+}
+
+}  // namespace
+
+struct Tlsf::Block {
+    // Previous block in memory, null for the first block.
+    Block* prev_phys;
+    // Payload size in bytes, the low bits hold the flags below.
+    std::size_t size_and_flags;
+    // Free list links, only valid while the block is free. They overlap the
+    // payload of allocated blocks.
+    Block* next_free;
+    Block* prev_free;
+
+    static constexpr std::size_t free_flag = 1;
+    static constexpr std::size_t prev_free_flag = 2;
+    static constexpr std::size_t flags = free_flag | prev_free_flag;
+
+    std::size_t size() const {
+        return size_and_flags & ~flags;
+    }
+
+    void set_size(std::size_t size) {
+        size_and_flags = size | (size_and_flags & flags);
+    }
+
+    bool is_free() const {
+        return (size_and_flags & free_flag) != 0;
+    }
+
+    void set_free(bool free) {
+        size_and_flags = free ? size_and_flags | free_flag
+                              : size_and_flags & ~free_flag;
+    }
+
+    bool is_prev_free() const {
+        return (size_and_flags & prev_free_flag) != 0;
+    }
+
+    void set_prev_free(bool free) {
+        size_and_flags = free ? size_and_flags | prev_free_flag
+                              : size_and_flags & ~prev_free_flag;
+    }
+
+    static Block* from_payload(const void* ptr) {
+        return reinterpret_cast<Block*>(
+            const_cast<unsigned char*>(static_cast<const unsigned char*>(ptr))
+            - header
+        );
+    }
+
+    unsigned char* payload() {
+        return reinterpret_cast<unsigned char*>(this) + header;
+    }
+
+    Block* next_phys() {
+        return reinterpret_cast<Block*>(payload() + size());
+    }
+};
+
+Tlsf::Tlsf(void* region, std::size_t size) {
+    const auto address = reinterpret_cast<uintptr_t>(region);
+    const uintptr_t begin = align_up(address, alignment_min);
+    const uintptr_t end = align_down(address + size, alignment_min);
+    // The first block and the sentinel that ends the region.
+    if (end < begin || end - begin < 2 * header + payload_min) {
+        panic("TLSF region too small");
+    }
+    std::size_t block_size = end - begin - 2 * header;
+    if (block_size > block_size_max) {
+        block_size = block_size_max;
+    }
+
+    auto* block = reinterpret_cast<Block*>(begin);
+    block->prev_phys = nullptr;
+    block->size_and_flags = block_size | Block::free_flag;
+
+    Block* sentinel = block->next_phys();
+    sentinel->prev_phys = block;
+    sentinel->size_and_flags = Block::prev_free_flag;
+
+    insert_free(block);
+    free_ = block_size;
+    free_blocks_ = 1;
+}
+
+Result<void*, CapacityError> Tlsf::try_allocate(
+    std::size_t size,
+    std::size_t alignment
+) {
+    if (alignment < alignment_min) {
+        alignment = alignment_min;
+    }
+    // No block is large enough for a larger alignment, and its slack
+    // would wrap the size check below.
+    if (alignment > block_size_max) {
+        return Err { CapacityError::Full };
+    }
+    // Over-aligned requests need room to split off a leading free block.
+    const std::size_t slack =
+        alignment > alignment_min ? alignment + header + payload_min : 0;
+    if (slack > block_size_max || size > block_size_max - slack) {
+        return Err { CapacityError::Full };
+    }
+    size = align_up(size, alignment_min);
+    if (size < payload_min) {
+        size = payload_min;
+    }
+
+    Index index = mapping_search(size + slack);
+    Block* block = find_free(index);
+    if (block == nullptr) {
+        return Err { CapacityError::Full };
+    }
+    remove_free(block, index);
+    free_ -= block->size();
+    --free_blocks_;
+
+    if (slack != 0) {
+        const auto payload = reinterpret_cast<uintptr_t>(block->payload());
+        if (payload % alignment != 0) {
+            Block* leading = block;
+            const uintptr_t aligned =
+                align_up(payload + header + payload_min, alignment);
+            block = split(leading, aligned - payload - header);
+            leading->set_free(true);
+            block->set_prev_free(true);
+            insert_free(leading);
+            free_ += leading->size();
+            ++free_blocks_;
+        }
+    }
+
+    Block* rest = split(block, size);
+    if (rest != nullptr) {
+        rest->set_free(true);
+        insert_free(rest);
+        free_ += rest->size();
+        ++free_blocks_;
+    }
+    block->set_free(false);
+    block->next_phys()->set_prev_free(false);
+
+    used_ += block->size();
+    if (used_ > peak_) {
+        peak_ = used_;
+    }
+    return Ok { static_cast<void*>(block->payload()) };
+}
+
+void Tlsf::free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    Block* block = Block::from_payload(ptr);
+    if (block->is_free()) {
+        panic("Double free");
+    }
+    used_ -= block->size();
+    free_ += block->size();
+    ++free_blocks_;
+
+    block->set_free(true);
+    block = merge_prev(block);
+    merge_next(block);
+    block->next_phys()->set_prev_free(true);
+    insert_free(block);
+}
+
+std::size_t Tlsf::usable_size(const void* ptr) {
+    return Block::from_payload(ptr)->size();
+}
+
+Tlsf::Stats Tlsf::stats() const {
+    std::size_t largest = 0;
+    if (fl_bitmap_ != 0) {
+        const unsigned fl = fls(fl_bitmap_);
+        const unsigned sl = fls(sl_bitmap_[fl]);
+        // All blocks in the list are within 1/16 of each other, a bounded
+        // scan is close enough.
+        std::size_t scanned = 0;
+        for (const Block* block = free_lists_[fl][sl];
+             block != nullptr && scanned < stats_scan_max;
+             block = block->next_free, ++scanned) {
+            if (block->size() > largest) {
+                largest = block->size();
+            }
+        }
+    }
+    return Stats { used_, peak_, free_, free_blocks_, largest };
+}
+
+Tlsf::Index Tlsf::mapping_insert(std::size_t size) {
+    if (size < small_block) {
+        return Index {
+            0,
+            static_cast<unsigned>(size / (small_block / sl_count)),
+        };
+    }
+    const unsigned f = fls(size);
+    return Index {
+        f - (fl_shift - 1),
+        static_cast<unsigned>(size >> (f - sl_count_log2)) ^ sl_count,
+    };
+}
+
+Tlsf::Index Tlsf::mapping_search(std::size_t size) {
+    // Round up to the next list, every block in it is large enough.
+    if (size >= small_block) {
+        size += (std::size_t { 1 } << (fls(size) - sl_count_log2)) - 1;
+    }
+    return mapping_insert(size);
+}
+
+Tlsf::Block* Tlsf::find_free(Index& index) const {
+    uint32_t sl_map = sl_bitmap_[index.fl] & (~0U << index.sl);
+    if (sl_map == 0) {
+        const uint32_t fl_map = fl_bitmap_ & (~0U << (index.fl + 1));
+        if (fl_map == 0) {
+            return nullptr;
+        }
+        index.fl = ffs(fl_map);
+        sl_map = sl_bitmap_[index.fl];
+    }
+    index.sl = ffs(sl_map);
+    return free_lists_[index.fl][index.sl];
+}
+
+void Tlsf::insert_free(Block* block) {
+    const Index index = mapping_insert(block->size());
+    Block*& head = free_lists_[index.fl][index.sl];
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if (head != nullptr) {
+        head->prev_free = block;
+    }
+    head = block;
+    fl_bitmap_ |= 1U << index.fl;
+    sl_bitmap_[index.fl] |= 1U << index.sl;
+}
+
+void Tlsf::remove_free(Block* block, Index index) {
+    if (block->next_free != nullptr) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free != nullptr) {
+        block->prev_free->next_free = block->next_free;
+    }
+    Block*& head = free_lists_[index.fl][index.sl];
+    if (head == block) {
+        head = block->next_free;
+        if (head == nullptr) {
+            sl_bitmap_[index.fl] &= ~(1U << index.sl);
+            if (sl_bitmap_[index.fl] == 0) {
+                fl_bitmap_ &= ~(1U << index.fl);
+            }
+        }
+    }
+}
+
+void Tlsf::remove_free(Block* block) {
+    remove_free(block, mapping_insert(block->size()));
+}
+
+Tlsf::Block* Tlsf::split(Block* block, std::size_t size) {
+    if (block->size() < size + header + payload_min) {
+        return nullptr;
+    }
+    auto* rest = reinterpret_cast<Block*>(block->payload() + size);
+    rest->prev_phys = block;
+    rest->size_and_flags = block->size() - size - header;
+    block->set_size(size);
+    rest->next_phys()->prev_phys = rest;
+    return rest;
+}
+
+Tlsf::Block* Tlsf::merge_prev(Block* block) {
+    if (!block->is_prev_free()) {
+        return block;
+    }
+    Block* prev = block->prev_phys;
+    remove_free(prev);
+    prev->set_size(prev->size() + header + block->size());
+    prev->next_phys()->prev_phys = prev;
+    free_ += header;
+    --free_blocks_;
+    return prev;
+}
+
+void Tlsf::merge_next(Block* block) {
+    Block* next = block->next_phys();
+    if (!next->is_free()) {
+        return;
+    }
+    remove_free(next);
+    block->set_size(block->size() + header + next->size());
+    block->next_phys()->prev_phys = block;
+    free_ += header;
+    --free_blocks_;
+}
+
+}  // namespace ccl
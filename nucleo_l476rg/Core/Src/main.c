@@ -18,6 +18,8 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "dma.h"
+#include "i2c.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -86,13 +88,14 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART2_UART_Init();
+  MX_I2C1_Init();
   /* USER CODE BEGIN 2 */
 
   struct HardwareHandles handles;
   handles.uart = &huart2;
-  handles.led_gpio_port = GPIOA;
-  handles.led_pin = GPIO_PIN_5;
+  handles.i2c = &hi2c1;
 
   /* USER CODE END 2 */
 
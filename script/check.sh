@@ -1,6 +1,6 @@
 #!/bin/bash
 
-find src lib -name *.cpp -o -name *.hpp \
+find src lib tests -name *.cpp -o -name *.hpp \
     | xargs clang-format -Werror --verbose --dry-run
 
 run-clang-tidy -p build src lib -quiet
\ No newline at end of file
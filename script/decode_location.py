@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Maps compact ccl::SourceLocation ids back to file, function and line.
+
+Usage:
+    decode_location.py firmware.elf [ID...]
+
+Ids are given in hex. Without ids, lines are read from stdin and every
+'at XXXXXXXX' (as printed in crash reports) is replaced by the decoded
+location.
+
+Requires pyelftools.
+"""
+
+import os
+import re
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+
+def file_hash(path):
+    """Same as ccl::detail::file_hash."""
+    name = re.split(r"[/\\]", path)[-1]
+    h = 2166136261
+    for byte in name.encode():
+        h = ((h ^ byte) * 16777619) & 0xFFFFFFFF
+    return (h >> 16) ^ (h & 0xFFFF)
+
+
+def die_name(die):
+    while die is not None:
+        if "DW_AT_name" in die.attributes:
+            return die.attributes["DW_AT_name"].value.decode()
+        for ref in ("DW_AT_specification", "DW_AT_abstract_origin"):
+            if ref in die.attributes:
+                die = die.get_DIE_from_attribute(ref)
+                break
+        else:
+            return "?"
+    return "?"
+
+
+def functions(dwarf):
+    ranges = []
+    for cu in dwarf.iter_CUs():
+        for die in cu.iter_DIEs():
+            if die.tag != "DW_TAG_subprogram":
+                continue
+            attrs = die.attributes
+            if "DW_AT_low_pc" not in attrs or "DW_AT_high_pc" not in attrs:
+                continue
+            low = attrs["DW_AT_low_pc"].value
+            high = attrs["DW_AT_high_pc"]
+            end = high.value if high.form == "DW_FORM_addr" else low + high.value
+            ranges.append((low, end, die_name(die)))
+    return ranges
+
+
+def locations(dwarf):
+    """Returns {(file hash, line): {(path, address)}} and {file hash: path}."""
+    lines = {}
+    files = {}
+    for cu in dwarf.iter_CUs():
+        program = dwarf.line_program_for_CU(cu)
+        if program is None:
+            continue
+        header = program.header
+        dirs = [d.decode() for d in header["include_directory"]]
+        base = 0 if header["version"] >= 5 else 1
+        for entry in program.get_entries():
+            state = entry.state
+            if state is None or state.end_sequence:
+                continue
+            file_entry = header["file_entry"][state.file - base]
+            path = file_entry.name.decode()
+            dir_index = file_entry.dir_index - base
+            if 0 <= dir_index < len(dirs):
+                path = os.path.join(dirs[dir_index], path)
+            key = file_hash(path)
+            files.setdefault(key, set()).add(path)
+            lines.setdefault((key, state.line), set()).add(
+                (path, state.address)
+            )
+    return lines, files
+
+
+class Decoder:
+    def __init__(self, elf_path):
+        with open(elf_path, "rb") as stream:
+            dwarf = ELFFile(stream).get_dwarf_info()
+            self.functions = functions(dwarf)
+            self.lines, self.files = locations(dwarf)
+
+    def function_at(self, address):
+        for low, high, name in self.functions:
+            if low <= address < high:
+                return name
+        return "?"
+
+    def decode(self, location_id):
+        key = location_id >> 16
+        line = location_id & 0xFFFF
+        rows = self.lines.get((key, line))
+        if rows:
+            found = sorted(
+                {(path, self.function_at(addr)) for path, addr in rows}
+            )
+            return " or ".join(f"{p}:{line} ({f})" for p, f in found)
+        # The line may have been optimized out, the file is still known.
+        paths = sorted(self.files.get(key, {"?"}))
+        return " or ".join(f"{p}:{line}" for p in paths)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    decoder = Decoder(sys.argv[1])
+    if len(sys.argv) > 2:
+        for arg in sys.argv[2:]:
+            print(f"{arg}: {decoder.decode(int(arg, 16))}")
+        return
+    pattern = re.compile(r"\bat ([0-9a-fA-F]{8})\b")
+    for line in sys.stdin:
+        sys.stdout.write(
+            pattern.sub(
+                lambda m: "at " + decoder.decode(int(m.group(1), 16)), line
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Decodes the binary ccl log stream into text.
+
+Usage:
+    decode_log.py firmware.elf < capture.bin
+    stty -F /dev/ttyACM0 115200 raw && decode_log.py firmware.elf < /dev/ttyACM0
+
+Format strings are read from the '.ccl_log' section of the ELF file. Log
+packets of the link are decoded and text packets (echoed input, crash
+reports) are printed as they are, see 'uart_link.py'. Profile packets are
+left to 'decode_profile.py'.
+
+Requires pyelftools.
+"""
+
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+import uart_link
+
+LEVELS = {"E": "ERROR", "W": "WARN", "I": "INFO", "D": "DEBUG"}
+
+# Sizes on the target, must match ccl::detail::parse_log_format.
+LENGTH_SIZES = {"hh": 1, "h": 2, "l": 4, "ll": 8, "z": 4, "j": 8, "t": 4}
+INT_SIZE = 4
+POINTER_SIZE = 4
+
+SPEC = re.compile(r"%(%|[-+ #0-9.]*)(hh|ll|h|l|z|j|t)?([diuxXocpfFeEgGaA])?")
+
+
+class Message:
+    def __init__(self, level, fmt):
+        self.level = LEVELS[level]
+        self.args = []  # (size, kind)
+        pieces = []
+        last = 0
+        for match in SPEC.finditer(fmt):
+            flags, length, conversion = match.groups()
+            pieces.append(fmt[last : match.start()].replace("%", "%%"))
+            last = match.end()
+            if flags == "%":
+                pieces.append("%%")
+                continue
+            if conversion in "fFeEgGaA":
+                self.args.append((4, "f"))
+                conversion = "e" if conversion in "aA" else conversion
+            elif conversion == "p":
+                self.args.append((POINTER_SIZE, "u"))
+                flags, conversion = "#", "x"
+            else:
+                size = LENGTH_SIZES[length] if length else INT_SIZE
+                kind = "i" if conversion in "di" else "u"
+                self.args.append((size, kind))
+            pieces.append("%" + flags + conversion)
+        pieces.append(fmt[last:].replace("%", "%%"))
+        self.template = "".join(pieces)
+        self.size = sum(size for size, _ in self.args)
+
+    def format(self, payload):
+        values = []
+        offset = 0
+        for size, kind in self.args:
+            raw = payload[offset : offset + size]
+            offset += size
+            if kind == "f":
+                values.append(struct.unpack("<f", raw)[0])
+            else:
+                values.append(int.from_bytes(raw, "little", signed=kind == "i"))
+        return f"[{self.level}] {self.template % tuple(values)}"
+
+
+def load_messages(elf_path):
+    with open(elf_path, "rb") as stream:
+        section = ELFFile(stream).get_section_by_name(".ccl_log")
+        if section is None:
+            sys.exit(f"{elf_path} has no .ccl_log section")
+        data = section.data()
+    messages = {}
+    offset = 0
+    while offset < len(data):
+        end = data.index(b"\0", offset)
+        text = data[offset:end].decode(errors="replace")
+        if text and text[0] in LEVELS:
+            messages[offset] = Message(text[0], text[1:])
+        offset = end + 1
+    return messages
+
+
+def decode(messages, payload, out):
+    """Decodes the log frames of one packet."""
+    i = 0
+    while i < len(payload):
+        length = payload[i]
+        frame = payload[i + 1 : i + 1 + length]
+        i += 1 + length
+        if length < 2 or len(frame) < length:
+            out.write("[?] truncated frame\n")
+            break
+        message = messages.get(frame[0] | frame[1] << 8)
+        if message is None or message.size + 2 != length:
+            out.write(f"[?] unknown message {frame[0] | frame[1] << 8:#06x}\n")
+            continue
+        out.write(message.format(frame[2:]) + "\n")
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    messages = load_messages(sys.argv[1])
+    for channel, payload in uart_link.read_packets(sys.stdin.buffer):
+        if channel == uart_link.LOG:
+            decode(messages, payload, sys.stdout)
+        elif channel == uart_link.TEXT:
+            sys.stdout.write(payload.decode(errors="replace"))
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Prints the ccl profile frames found in a UART capture.
+
+Usage:
+    decode_profile.py [cpu_hz] < capture.bin
+
+Frames are written by 'ccl::ProfileTable::serialize' and sent in the profile
+packets of the link, see 'uart_link.py'. Other packets are skipped. With
+'cpu_hz' the durations are also printed in microseconds.
+"""
+
+import struct
+import sys
+
+import uart_link
+
+MAGIC = b"PROF"
+
+
+def parse_frame(payload):
+    zones = []
+    count, buckets = payload[0], payload[1]
+    offset = 2
+    for _ in range(count):
+        size = payload[offset]
+        name = payload[offset + 1 : offset + 1 + size].decode(errors="replace")
+        offset += 1 + size
+        runs, low, high, total, mask = struct.unpack_from("<IIIQI", payload, offset)
+        offset += 24
+        histogram = [0] * buckets
+        for bucket in range(buckets):
+            if mask & 1 << bucket:
+                histogram[bucket] = struct.unpack_from("<I", payload, offset)[0]
+                offset += 4
+        zones.append((name, runs, low, high, total, histogram))
+    return zones
+
+
+def print_zones(zones, cpu_hz, out):
+    def cycles(value):
+        if cpu_hz is None:
+            return f"{value}"
+        return f"{value} ({value * 1e6 / cpu_hz:.1f} us)"
+
+    for name, runs, low, high, total, histogram in zones:
+        if runs == 0:
+            out.write(f"{name}: never entered\n")
+            continue
+        out.write(
+            f"{name}: {runs} runs, min {cycles(low)}, "
+            f"mean {cycles(total // runs)}, max {cycles(high)}\n"
+        )
+        for bucket, hits in enumerate(histogram):
+            if hits:
+                bar = "#" * max(1, hits * 40 // runs)
+                out.write(f"  >= 2^{bucket:<2} {hits:>10} {bar}\n")
+
+
+def main():
+    if len(sys.argv) > 2:
+        sys.exit(__doc__)
+    cpu_hz = float(sys.argv[1]) if len(sys.argv) == 2 else None
+    for channel, payload in uart_link.read_packets(sys.stdin.buffer):
+        if channel != uart_link.PROFILE or not payload.startswith(MAGIC):
+            continue
+        header = len(MAGIC)
+        try:
+            length = struct.unpack_from("<H", payload, header)[0]
+            zones = parse_frame(payload[header + 2 : header + 2 + length])
+        except (IndexError, struct.error):
+            sys.stdout.write("Corrupted profile frame\n\n")
+            continue
+        print_zones(zones, cpu_hz, sys.stdout)
+        sys.stdout.write("\n")
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
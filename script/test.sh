@@ -0,0 +1,7 @@
+#!/bin/bash
+
+cmake -S tests -B build-tests
+
+cmake --build build-tests
+
+ctest --test-dir build-tests --output-on-failure
\ No newline at end of file
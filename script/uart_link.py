@@ -0,0 +1,43 @@
+"""Splits the USART2 ground link stream into packets.
+
+The firmware sends every packet COBS encoded and terminated by a zero byte,
+with the channel in its first byte, see 'src/link_packet.hpp'. Corrupted
+packets are skipped, the stream resynchronizes at the next zero byte.
+"""
+
+LOG = 1
+TEXT = 2
+PROFILE = 3
+
+
+def cobs_decode(data):
+    """Decodes one packet without its delimiter, raises ValueError if it is
+    corrupted."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("Invalid COBS packet")
+        out += data[i + 1 : i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def read_packets(stream):
+    """Yields the (channel, payload) of each packet read from 'stream'."""
+    pending = b""
+    while True:
+        chunk = stream.read1(4096)
+        if not chunk:
+            break
+        *packets, pending = (pending + chunk).split(b"\0")
+        for packet in packets:
+            try:
+                payload = cobs_decode(packet)
+            except ValueError:
+                continue
+            if payload:
+                yield payload[0], payload[1:]
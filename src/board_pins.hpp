@@ -0,0 +1,118 @@
+/// Pins of the Nucleo-L476RG board.
+///
+/// 'cube_pins' mirrors the pins labeled in CubeMX, taken from the
+/// '<label>_Pin' and '<label>_GPIO_Port' defines in 'main.h'. The port
+/// defines expand to pointer casts, which are not constant expressions, so
+/// the 'GPIOx' macros are temporarily redefined to 'Port' values while the
+/// table is built.
+///
+/// The static assertions below fail to compile if two labels share a pin
+/// or if a pin used by the firmware is not the one CubeMX labeled for it.
+/// New CubeMX labels must be added to 'cube_pins'.
+
+#ifndef OBC_BOARD_PINS_HPP
+#define OBC_BOARD_PINS_HPP
+
+#include <cstddef>
+#include <iterator>
+
+#include "main.h"
+#include "pin.hpp"
+
+namespace obc::board {
+
+struct LabeledPin {
+    const char* label;
+    PinId id;
+};
+
+#pragma push_macro("GPIOA")
+#pragma push_macro("GPIOB")
+#pragma push_macro("GPIOC")
+#pragma push_macro("GPIOD")
+#pragma push_macro("GPIOE")
+#pragma push_macro("GPIOF")
+#pragma push_macro("GPIOG")
+#pragma push_macro("GPIOH")
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOF
+#undef GPIOG
+#undef GPIOH
+#define GPIOA ::obc::Port::A
+#define GPIOB ::obc::Port::B
+#define GPIOC ::obc::Port::C
+#define GPIOD ::obc::Port::D
+#define GPIOE ::obc::Port::E
+#define GPIOF ::obc::Port::F
+#define GPIOG ::obc::Port::G
+#define GPIOH ::obc::Port::H
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define OBC_CUBE_PIN(label) \
+    LabeledPin { #label, PinId { label##_GPIO_Port, label##_Pin } }
+
+// NOLINTNEXTLINE(*-avoid-c-arrays)
+inline constexpr LabeledPin cube_pins[] = {
+    OBC_CUBE_PIN(B1),
+    OBC_CUBE_PIN(USART_TX),
+    OBC_CUBE_PIN(USART_RX),
+    OBC_CUBE_PIN(LD2),
+    OBC_CUBE_PIN(TMS),
+    OBC_CUBE_PIN(TCK),
+    OBC_CUBE_PIN(SWO),
+    OBC_CUBE_PIN(I2C_SCL),
+    OBC_CUBE_PIN(I2C_SDA),
+};
+
+#undef OBC_CUBE_PIN
+#pragma pop_macro("GPIOA")
+#pragma pop_macro("GPIOB")
+#pragma pop_macro("GPIOC")
+#pragma pop_macro("GPIOD")
+#pragma pop_macro("GPIOE")
+#pragma pop_macro("GPIOF")
+#pragma pop_macro("GPIOG")
+#pragma pop_macro("GPIOH")
+
+constexpr bool same_label(const char* lhs, const char* rhs) {
+    while (*lhs != '\0' && *lhs == *rhs) {
+        ++lhs;
+        ++rhs;
+    }
+    return *lhs == *rhs;
+}
+
+/// True if no two labels share a pin.
+constexpr bool labels_are_distinct() {
+    for (std::size_t i = 0; i < std::size(cube_pins); ++i) {
+        for (std::size_t j = i + 1; j < std::size(cube_pins); ++j) {
+            if (cube_pins[i].id == cube_pins[j].id) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// True if 'id' is the pin CubeMX labeled 'label'.
+constexpr bool is_labeled(PinId id, const char* label) {
+    for (const LabeledPin& pin : cube_pins) {
+        if (same_label(pin.label, label)) {
+            return pin.id == id;
+        }
+    }
+    return false;
+}
+
+static_assert(labels_are_distinct(), "CubeMX labels share a pin");
+
+using Led = Pin<Port::A, 5>;
+static_assert(is_labeled(Led::id, "LD2"), "LED is not on pin LD2");
+
+}  // namespace obc::board
+
+#endif
@@ -0,0 +1,316 @@
+#include "clock_manager.hpp"
+
+#include <ccl/static_vector.hpp>
+#include <cstddef>
+#include <utility>
+
+#include "interrupt_lock.hpp"
+#include "systick_clock.hpp"
+
+using namespace ccl::prelude;
+
+namespace obc {
+
+namespace {
+
+struct PointConfig {
+    bool pll;
+    uint32_t msi_range;
+    uint32_t voltage_scale;
+    uint32_t flash_latency;
+    /// I2C timing for PCLK1 = SYSCLK.
+    uint32_t i2c_timing;
+};
+
+// Indexed by 'OperatingPoint'. The I2C timings are the CubeMX one for
+// 80 MHz, the reference manual one for 8 MHz with PRESC = 2 for 24 MHz,
+// and one computed for standard mode at 2 MHz.
+constexpr PointConfig configs[] = {
+    { true, 0, PWR_REGULATOR_VOLTAGE_SCALE1, FLASH_LATENCY_4, 0x00702991 },
+    { false,
+      RCC_MSIRANGE_9,
+      PWR_REGULATOR_VOLTAGE_SCALE2,
+      FLASH_LATENCY_3,
+      0x20310309 },
+    { false,
+      RCC_MSIRANGE_5,
+      PWR_REGULATOR_VOLTAGE_SCALE2,
+      FLASH_LATENCY_0,
+      0x00200709 },
+};
+
+constexpr std::size_t max_listeners = 4;
+
+// About 5 ms at 80 MHz and longer at the slower points, more than any
+// oscillator needs to start. The HAL RCC functions wait with 'HAL_GetTick',
+// which does not advance with interrupts masked, so a failing oscillator
+// would hang them.
+constexpr uint32_t ready_timeout_cycles = 400'000;
+
+OperatingPoint current_point = OperatingPoint::Full;
+ccl::StaticVector<ClockManager::Listener, max_listeners> listeners;
+
+const PointConfig& config(OperatingPoint point) {
+    return configs[static_cast<std::size_t>(point)];
+}
+
+template <typename Ready>
+HAL_StatusTypeDef wait_until(Ready ready) {
+    const uint32_t start = SysTickClock::cycles();
+    while (!ready()) {
+        if (SysTickClock::cycles() - start > ready_timeout_cycles) {
+            return HAL_TIMEOUT;
+        }
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef set_flash_latency(uint32_t latency) {
+    __HAL_FLASH_SET_LATENCY(latency);
+    // The new latency is in effect once it reads back.
+    return __HAL_FLASH_GET_LATENCY() == latency ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef start_source(const PointConfig& to) {
+    if (to.pll) {
+        // As in 'SystemClock_Config'. The PLL is only off after a stop or
+        // when coming from an MSI point, and can be configured then.
+        if (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) != 0) {
+            return HAL_OK;
+        }
+        __HAL_RCC_HSI_ENABLE();
+        const HAL_StatusTypeDef status = wait_until([] {
+            return __HAL_RCC_GET_FLAG(RCC_FLAG_HSIRDY) != 0;
+        });
+        if (status != HAL_OK) {
+            return status;
+        }
+        __HAL_RCC_PLL_CONFIG(
+            RCC_PLLSOURCE_HSI,
+            1,
+            10,
+            RCC_PLLP_DIV7,
+            RCC_PLLQ_DIV2,
+            RCC_PLLR_DIV2
+        );
+        __HAL_RCC_PLL_ENABLE();
+        __HAL_RCC_PLLCLKOUT_ENABLE(RCC_PLL_SYSCLK);
+        return wait_until([] {
+            return __HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) != 0;
+        });
+    }
+
+    // The range may only change while the MSI is off or ready.
+    __HAL_RCC_MSI_ENABLE();
+    const auto msi_ready = [] {
+        return __HAL_RCC_GET_FLAG(RCC_FLAG_MSIRDY) != 0;
+    };
+    const HAL_StatusTypeDef status = wait_until(msi_ready);
+    if (status != HAL_OK) {
+        return status;
+    }
+    __HAL_RCC_MSI_RANGE_CONFIG(to.msi_range);
+    __HAL_RCC_MSI_CALIBRATIONVALUE_ADJUST(RCC_MSICALIBRATION_DEFAULT);
+    return wait_until(msi_ready);
+}
+
+// Kernel clocks of the UARTs that wake up the core, see
+// 'TicklessClock::enable_uart_wakeup'.
+bool hsi_kernel_clock_used() {
+    return __HAL_RCC_GET_USART1_SOURCE() == RCC_USART1CLKSOURCE_HSI
+        || __HAL_RCC_GET_USART2_SOURCE() == RCC_USART2CLKSOURCE_HSI
+        || __HAL_RCC_GET_USART3_SOURCE() == RCC_USART3CLKSOURCE_HSI;
+}
+
+HAL_StatusTypeDef stop_source(const PointConfig& from) {
+    if (from.pll) {
+        __HAL_RCC_PLL_DISABLE();
+        const HAL_StatusTypeDef status = wait_until([] {
+            return __HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == 0;
+        });
+        if (status != HAL_OK) {
+            return status;
+        }
+        __HAL_RCC_PLLCLKOUT_DISABLE(RCC_PLL_SYSCLK);
+        if (!hsi_kernel_clock_used()) {
+            __HAL_RCC_HSI_DISABLE();
+        }
+    } else {
+        __HAL_RCC_MSI_DISABLE();
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef reconfigure(const PointConfig& from, const PointConfig& to) {
+    HAL_StatusTypeDef status = HAL_OK;
+    if (to.voltage_scale == PWR_REGULATOR_VOLTAGE_SCALE1
+        && from.voltage_scale != PWR_REGULATOR_VOLTAGE_SCALE1) {
+        // Bounded by a loop count, not by 'HAL_GetTick'.
+        status = HAL_PWREx_ControlVoltageScaling(to.voltage_scale);
+        if (status != HAL_OK) {
+            return status;
+        }
+    }
+
+    // Raise the flash latency before the clock, also before the MSI range
+    // if the MSI already clocks the core.
+    if (to.flash_latency > __HAL_FLASH_GET_LATENCY()) {
+        status = set_flash_latency(to.flash_latency);
+        if (status != HAL_OK) {
+            return status;
+        }
+    }
+    status = start_source(to);
+    if (status != HAL_OK) {
+        return status;
+    }
+    // STOP clears HSION, the MSI points wake up without it.
+    if (!to.pll && hsi_kernel_clock_used()) {
+        __HAL_RCC_HSI_ENABLE();
+        status = wait_until([] {
+            return __HAL_RCC_GET_FLAG(RCC_FLAG_HSIRDY) != 0;
+        });
+        if (status != HAL_OK) {
+            return status;
+        }
+    }
+    const uint32_t source =
+        to.pll ? RCC_SYSCLKSOURCE_PLLCLK : RCC_SYSCLKSOURCE_MSI;
+    __HAL_RCC_SYSCLK_CONFIG(source);
+    status = wait_until([source] {
+        return __HAL_RCC_GET_SYSCLK_SOURCE()
+            == source << RCC_CFGR_SWS_Pos;
+    });
+    if (status != HAL_OK) {
+        return status;
+    }
+    if (to.flash_latency < __HAL_FLASH_GET_LATENCY()) {
+        status = set_flash_latency(to.flash_latency);
+        if (status != HAL_OK) {
+            return status;
+        }
+    }
+    if (to.pll != from.pll) {
+        status = stop_source(from);
+        if (status != HAL_OK) {
+            return status;
+        }
+    }
+
+    if (to.voltage_scale != PWR_REGULATOR_VOLTAGE_SCALE1
+        && from.voltage_scale == PWR_REGULATOR_VOLTAGE_SCALE1) {
+        status = HAL_PWREx_ControlVoltageScaling(to.voltage_scale);
+        if (status != HAL_OK) {
+            return status;
+        }
+    }
+
+    if (!to.pll && __HAL_RCC_GET_FLAG(RCC_FLAG_LSERDY) != 0) {
+        HAL_RCCEx_EnableMSIPLLMode();
+    }
+    __HAL_RCC_WAKEUPSTOP_CLK_CONFIG(
+        to.pll ? RCC_STOP_WAKEUPCLOCK_HSI : RCC_STOP_WAKEUPCLOCK_MSI
+    );
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef switch_clocks(
+    const PointConfig& from,
+    const PointConfig& to
+) {
+    const HAL_StatusTypeDef status = reconfigure(from, to);
+    // Also after a failure, SysTick follows the clock that actually runs.
+    SystemCoreClockUpdate();
+    HAL_InitTick(uwTickPrio);
+    return status;
+}
+
+void notify(OperatingPoint point) {
+    for (const ClockManager::Listener& listener : listeners) {
+        listener(point);
+    }
+}
+
+}  // namespace
+
+void ClockManager::init() {
+    // Bounds the oscillator waits.
+    SysTickClock::init();
+    // Wake up on HSI16, the PLL source, so the PLL restarts without waiting
+    // for another oscillator.
+    __HAL_RCC_WAKEUPSTOP_CLK_CONFIG(RCC_STOP_WAKEUPCLOCK_HSI);
+}
+
+Result<ccl::Unit, HAL_StatusTypeDef> ClockManager::set(OperatingPoint point) {
+    const InterruptLock lock;
+    if (point == current_point) {
+        return Ok { ccl::Unit {} };
+    }
+    const HAL_StatusTypeDef status =
+        switch_clocks(config(current_point), config(point));
+    if (status != HAL_OK) {
+        return Err { status };
+    }
+    current_point = point;
+    notify(point);
+    return Ok { ccl::Unit {} };
+}
+
+OperatingPoint ClockManager::current() {
+    return current_point;
+}
+
+Result<ccl::Unit, HAL_StatusTypeDef> ClockManager::restore() {
+    const PointConfig& point = config(current_point);
+    const HAL_StatusTypeDef status = switch_clocks(point, point);
+    if (status != HAL_OK) {
+        // Let the UARTs follow the wakeup clock the core continues on.
+        notify(current_point);
+        return Err { status };
+    }
+    return Ok { ccl::Unit {} };
+}
+
+Result<ccl::Unit, ccl::CapacityError> ClockManager::try_subscribe(
+    Listener listener
+) {
+    const InterruptLock lock;
+    return listeners.try_push(std::move(listener));
+}
+
+void retune_uart(UART_HandleTypeDef* huart) {
+    UART_ClockSourceTypeDef source = UART_CLOCKSOURCE_UNDEFINED;
+    UART_GETCLOCKSOURCE(huart, source);
+    uint32_t pclk = 0;
+    if (source == UART_CLOCKSOURCE_PCLK1) {
+        pclk = HAL_RCC_GetPCLK1Freq();
+    } else if (source == UART_CLOCKSOURCE_PCLK2) {
+        pclk = HAL_RCC_GetPCLK2Freq();
+    } else {
+        // HSI16 or LSE, independent of the operating point.
+        return;
+    }
+    const uint32_t baud = huart->Init.BaudRate;
+    uint32_t brr = 0;
+    if (huart->Init.OverSampling == UART_OVERSAMPLING_8) {
+        const uint32_t div = (2 * pclk + baud / 2) / baud;
+        brr = (div & 0xFFF0U) | ((div & 0x000FU) >> 1U);
+    } else {
+        brr = (pclk + baud / 2) / baud;
+    }
+    // BRR can only be written while the UART is disabled.
+    __HAL_UART_DISABLE(huart);
+    huart->Instance->BRR = brr;
+    __HAL_UART_ENABLE(huart);
+}
+
+void retune_i2c(I2C_HandleTypeDef* hi2c, OperatingPoint point) {
+    const uint32_t timing = config(point).i2c_timing;
+    // TIMINGR can only be written while the I2C is disabled.
+    __HAL_I2C_DISABLE(hi2c);
+    hi2c->Instance->TIMINGR = timing;
+    hi2c->Init.Timing = timing;
+    __HAL_I2C_ENABLE(hi2c);
+}
+
+}  // namespace obc
@@ -0,0 +1,101 @@
+/// Runtime switching between clock operating points.
+///
+/// 'ClockManager' switches the system clock between predefined operating
+/// points, to run at full speed only while there is heavy work to do:
+///
+/// | Point  | SYSCLK | Source    | Voltage range | Flash latency |
+/// |--------|--------|-----------|---------------|---------------|
+/// | Full   | 80 MHz | HSI16 PLL | 1             | 4 wait states |
+/// | Medium | 24 MHz | MSI       | 2             | 3 wait states |
+/// | Low    | 2 MHz  | MSI       | 2             | 0 wait states |
+///
+/// 'Full' is the configuration 'SystemClock_Config' sets up at reset. When
+/// speeding up, the voltage range and the flash latency are raised before
+/// the clock, when slowing down they are lowered after. Oscillators that are
+/// no longer used are turned off. Once the LSE runs, the MSI is trimmed by
+/// it.
+///
+/// Switches run with interrupts masked, so they wait for the oscillators
+/// with a bound in DWT cycles rather than with the HAL RCC functions, whose
+/// 'HAL_GetTick' timeouts would never expire. A switch that times out leaves
+/// the core on a running clock and SysTick set up for it.
+///
+/// AHB and APB run at SYSCLK in all points. SysTick is reconfigured to keep
+/// its 1 ms period, the DWT cycle counter runs at the new frequency.
+/// Peripherals clocked by PCLK need new dividers. HSI16 stays on in the MSI
+/// points while it is the kernel clock of a UART. Listeners subscribed with
+/// 'try_subscribe' are called after each switch with interrupts masked,
+/// 'retune_uart' and 'retune_i2c' do the work for the UARTs and I2Cs.
+/// A transfer in progress during a switch is corrupted, switch only while
+/// they are idle.
+///
+/// # Examples
+///
+/// ```
+/// ClockManager::try_subscribe([](OperatingPoint) { retune_uart(&huart1); })
+///     .expect("Too many clock listeners");
+///
+/// ClockManager::set(OperatingPoint::Full).expect("Cannot speed up");
+/// compute();
+/// ClockManager::set(OperatingPoint::Low).expect("Cannot slow down");
+/// ```
+
+#ifndef OBC_CLOCK_MANAGER_HPP
+#define OBC_CLOCK_MANAGER_HPP
+
+#include <ccl/capacity_error.hpp>
+#include <ccl/inplace_function.hpp>
+#include <ccl/result.hpp>
+#include <cstdint>
+
+#include "hal_status.hpp"
+#include "stm32l4xx_hal.h"
+
+// See 'hal_status.hpp'.
+static_assert(
+    sizeof(ccl::Result<ccl::Unit, HAL_StatusTypeDef>)
+        == sizeof(HAL_StatusTypeDef),
+    "HAL_StatusTypeDef must use HAL_OK as its niche"
+);
+
+namespace obc {
+
+enum class OperatingPoint : uint8_t { Full, Medium, Low };
+
+struct ClockManager {
+    using Listener = ccl::InplaceFunction<void(OperatingPoint)>;
+
+    /// Prepares the wakeup from stop mode for the reset configuration, 'Full',
+    /// and enables the DWT cycle counter.
+    static void init();
+
+    /// Switches to 'point' and notifies the listeners. Does nothing if
+    /// 'point' is the current one.
+    static ccl::Result<ccl::Unit, HAL_StatusTypeDef> set(OperatingPoint point);
+
+    static OperatingPoint current();
+
+    /// Restores the clocks of the current point after a stop, which wakes up
+    /// on HSI16 or MSI with the PLL off. Called with interrupts masked. On
+    /// failure the core continues on the wakeup clock and the listeners are
+    /// notified, so 'retune_uart' adapts to it.
+    static ccl::Result<ccl::Unit, HAL_StatusTypeDef> restore();
+
+    static ccl::Result<ccl::Unit, ccl::CapacityError> try_subscribe(
+        Listener listener
+    );
+};
+
+/// Recomputes the baud rate divider of a UART clocked by PCLK1 or PCLK2.
+/// UARTs on other kernel clocks are left alone, so only subscribe it for
+/// UARTs on PCLK. USART2 runs on HSI16 once it wakes the core up, see
+/// 'TicklessClock::enable_uart_wakeup'.
+void retune_uart(UART_HandleTypeDef* huart);
+
+/// Sets the I2C timing for the PCLK1 of 'point'. The bus runs at 400 kHz,
+/// at 100 kHz in 'Low' where PCLK1 is too slow for fast mode.
+void retune_i2c(I2C_HandleTypeDef* hi2c, OperatingPoint point);
+
+}  // namespace obc
+
+#endif
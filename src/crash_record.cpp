@@ -0,0 +1,137 @@
+#include "crash_record.hpp"
+
+#include <ccl/panic.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "stm32l4xx_hal.h"
+
+namespace obc {
+
+namespace {
+
+constexpr uint32_t crash_magic = 0xDEADC0DE;
+
+__attribute__((section(".noinit"))) CrashRecord retained;
+
+uint32_t checksum(const CrashRecord& record) {
+    // FNV-1a over everything but the checksum itself.
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+    uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < offsetof(CrashRecord, checksum); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void copy_head(char* dest, std::size_t size, std::string_view src) {
+    if (src.size() >= size) {
+        src.remove_suffix(src.size() - (size - 1));
+    }
+    std::memcpy(dest, src.data(), src.size());
+    std::memset(dest + src.size(), 0, size - src.size());
+}
+
+[[noreturn]] void save_and_reset(CrashRecord::Reason reason) {
+    retained.magic = crash_magic;
+    retained.reason = reason;
+    retained.cfsr = SCB->CFSR;
+    retained.hfsr = SCB->HFSR;
+    retained.mmfar = SCB->MMFAR;
+    retained.bfar = SCB->BFAR;
+    retained.uptime_ms = HAL_GetTick();
+    retained.checksum = checksum(retained);
+    NVIC_SystemReset();
+}
+
+bool is_in_ram(const uint32_t* frame) {
+    const auto address = reinterpret_cast<uintptr_t>(frame);
+    return address >= SRAM1_BASE
+           && address + 8 * sizeof(uint32_t) <= SRAM1_BASE + SRAM1_SIZE_MAX;
+}
+
+}  // namespace
+
+std::optional<CrashRecord> take_crash_record() {
+    if (retained.magic != crash_magic
+        || retained.checksum != checksum(retained)) {
+        return std::nullopt;
+    }
+    const CrashRecord record = retained;
+    retained.magic = 0;
+    return record;
+}
+
+std::size_t format_crash_record(
+    const CrashRecord& record,
+    uint32_t boot_ms,
+    char* buffer,
+    std::size_t size
+) {
+    const bool panic = record.reason == CrashRecord::Reason::panic;
+    const int written = std::snprintf(
+        buffer,
+        size,
+        "crash: %s at %08lx \"%.*s\" pc=%08lx lr=%08lx xpsr=%08lx "
+        "cfsr=%08lx hfsr=%08lx mmfar=%08lx bfar=%08lx uptime=%lums "
+        "boot=%lums\r\n",
+        panic ? "panic" : "hard fault",
+        static_cast<unsigned long>(record.location),
+        static_cast<int>(sizeof(record.message)),
+        record.message,
+        static_cast<unsigned long>(record.pc),
+        static_cast<unsigned long>(record.lr),
+        static_cast<unsigned long>(record.xpsr),
+        static_cast<unsigned long>(record.cfsr),
+        static_cast<unsigned long>(record.hfsr),
+        static_cast<unsigned long>(record.mmfar),
+        static_cast<unsigned long>(record.bfar),
+        static_cast<unsigned long>(record.uptime_ms),
+        static_cast<unsigned long>(boot_ms)
+    );
+    if (written < 0) {
+        return 0;
+    }
+    return static_cast<std::size_t>(written) < size
+               ? static_cast<std::size_t>(written)
+               : size - 1;
+}
+
+}  // namespace obc
+
+namespace ccl {
+
+void panic_hook(std::string_view msg, SourceLocation loc) {
+    __disable_irq();
+    obc::retained.pc = 0;
+    obc::retained.lr = 0;
+    obc::retained.xpsr = 0;
+    obc::retained.location = loc.id();
+    obc::copy_head(
+        obc::retained.message,
+        sizeof(obc::retained.message),
+        msg
+    );
+    obc::save_and_reset(obc::CrashRecord::Reason::panic);
+}
+
+}  // namespace ccl
+
+/// Called from 'HardFault_Handler' with the exception frame of the faulting
+/// context.
+extern "C" void obc_hard_fault(const uint32_t* frame) {
+    if (obc::is_in_ram(frame)) {
+        obc::retained.lr = frame[5];
+        obc::retained.pc = frame[6];
+        obc::retained.xpsr = frame[7];
+    } else {
+        // Stacking failed, the frame cannot be read.
+        obc::retained.lr = 0;
+        obc::retained.pc = 0;
+        obc::retained.xpsr = 0;
+    }
+    obc::retained.location = 0;
+    std::memset(obc::retained.message, 0, sizeof(obc::retained.message));
+    obc::save_and_reset(obc::CrashRecord::Reason::hard_fault);
+}
@@ -0,0 +1,70 @@
+/// Crash record retained across resets.
+///
+/// When the firmware panics or takes a hard fault, the fault state is
+/// written to a record in the '.noinit' section of SRAM2 and the device is
+/// reset. SRAM2 is neither cleared nor initialized by the startup code, so
+/// the record is still there after the reset and can be reported once at
+/// the next boot.
+///
+/// Nothing is done on the normal path: the record is only written from the
+/// panic hook and from the hard fault handler.
+///
+/// # Examples
+///
+/// ```
+/// if (auto record = obc::take_crash_record()) {
+///     report(*record);
+/// }
+/// ```
+
+#ifndef OBC_CRASH_RECORD_HPP
+#define OBC_CRASH_RECORD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace obc {
+
+struct CrashRecord {
+    enum class Reason : uint32_t {
+        panic = 1,
+        hard_fault = 2,
+    };
+
+    uint32_t magic;
+    Reason reason;
+    /// Stacked registers of the faulting context, zero for panics.
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t xpsr;
+    /// Fault status and address registers from the SCB.
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t uptime_ms;
+    /// 'SourceLocation::id' of the panic, decoded on the host by
+    /// 'script/decode_location.py'.
+    uint32_t location;
+    /// Panic message, truncated to fit.
+    char message[32];
+    uint32_t checksum;
+};
+
+/// Returns the record written before the last reset, if there is a valid
+/// one, and invalidates it so that it is reported only once.
+std::optional<CrashRecord> take_crash_record();
+
+/// Formats 'record' as a single text line. Returns the number of characters
+/// written, excluding the terminating null.
+std::size_t format_crash_record(
+    const CrashRecord& record,
+    uint32_t boot_ms,
+    char* buffer,
+    std::size_t size
+);
+
+}  // namespace obc
+
+#endif
@@ -0,0 +1,44 @@
+/// Routing of the HAL weak completion callbacks to the driver objects
+/// registered for the given handle.
+
+#include "hal_callbacks.hpp"
+
+namespace obc::hal {
+
+ccl::CallbackTable<UART_HandleTypeDef, void(uint16_t), max_uarts>
+    uart_rx_event;
+UartCallbacks uart_rx_error;
+UartCallbacks uart_tx_complete;
+UartCallbacks uart_tx_error;
+I2cCallbacks i2c_transfer_complete;
+I2cCallbacks i2c_error;
+
+}  // namespace obc::hal
+
+extern "C" {
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t size) {
+    obc::hal::uart_rx_event.dispatch(huart, size);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+    obc::hal::uart_tx_complete.dispatch(huart);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+    obc::hal::uart_rx_error.dispatch(huart);
+    obc::hal::uart_tx_error.dispatch(huart);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    obc::hal::i2c_transfer_complete.dispatch(hi2c);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    obc::hal::i2c_transfer_complete.dispatch(hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
+    obc::hal::i2c_error.dispatch(hi2c);
+}
+}
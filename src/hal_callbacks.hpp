@@ -0,0 +1,40 @@
+/// Callback tables for the HAL weak completion callbacks.
+///
+/// Each driver binds its handlers to the handle it owns. The HAL callbacks
+/// defined in 'hal_callbacks.cpp' dispatch to all handlers bound to the
+/// handle they are called with.
+
+#ifndef OBC_HAL_CALLBACKS_HPP
+#define OBC_HAL_CALLBACKS_HPP
+
+#include <ccl/callback_table.hpp>
+#include <cstdint>
+
+#include "stm32l4xx_hal.h"
+
+namespace obc::hal {
+
+inline constexpr std::size_t max_uarts = 2;
+inline constexpr std::size_t max_i2cs = 2;
+
+using UartCallbacks = ccl::CallbackTable<UART_HandleTypeDef, void(), max_uarts>;
+using I2cCallbacks = ccl::CallbackTable<I2C_HandleTypeDef, void(), max_i2cs>;
+
+/// 'HAL_UARTEx_RxEventCallback', called with the DMA write position.
+extern ccl::CallbackTable<UART_HandleTypeDef, void(uint16_t), max_uarts>
+    uart_rx_event;
+/// 'HAL_UART_ErrorCallback' for the receivers.
+extern UartCallbacks uart_rx_error;
+/// 'HAL_UART_TxCpltCallback'.
+extern UartCallbacks uart_tx_complete;
+/// 'HAL_UART_ErrorCallback' for the transmitters.
+extern UartCallbacks uart_tx_error;
+
+/// 'HAL_I2C_MemRxCpltCallback' and 'HAL_I2C_MemTxCpltCallback'.
+extern I2cCallbacks i2c_transfer_complete;
+/// 'HAL_I2C_ErrorCallback'.
+extern I2cCallbacks i2c_error;
+
+}  // namespace obc::hal
+
+#endif
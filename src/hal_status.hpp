@@ -0,0 +1,40 @@
+/// 'HAL_OK' is never reported as an error, so it is the niche of
+/// 'HAL_StatusTypeDef' and 'Result<Unit, HAL_StatusTypeDef>' is as small as
+/// the status itself. 'Err { HAL_OK }' panics, so only wrap a status after
+/// checking it.
+///
+/// Every translation unit that uses 'HAL_StatusTypeDef' as a Result error
+/// must see this specialization, otherwise the Result layouts would differ
+/// between translation units. The headers declaring such Results include
+/// this one and repeat the size check below right after their includes, so
+/// losing the include fails to compile instead of breaking the layout.
+///
+/// # Examples
+///
+/// ```
+/// const HAL_StatusTypeDef status = HAL_UART_Init(huart);
+/// if (status != HAL_OK) {
+///     return Err { status };
+/// }
+/// ```
+
+#ifndef OBC_HAL_STATUS_HPP
+#define OBC_HAL_STATUS_HPP
+
+#include <ccl/niche.hpp>
+#include <ccl/result.hpp>
+
+#include "stm32l4xx_hal.h"
+
+template <>
+struct ccl::Niche<HAL_StatusTypeDef> {
+    static constexpr HAL_StatusTypeDef value = HAL_OK;
+};
+
+static_assert(
+    sizeof(ccl::Result<ccl::Unit, HAL_StatusTypeDef>)
+        == sizeof(HAL_StatusTypeDef),
+    "HAL_StatusTypeDef must use HAL_OK as its niche"
+);
+
+#endif
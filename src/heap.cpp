@@ -0,0 +1,201 @@
+#include "heap.hpp"
+
+#include <ccl/panic.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "interrupt_lock.hpp"
+
+namespace obc {
+
+namespace {
+
+__attribute__((section(".ram2"), aligned(8))) unsigned char
+    heap_region[OBC_HEAP_SIZE];
+
+// Constructed on first use, static constructors may already allocate.
+ccl::Tlsf& heap() {
+    static ccl::Tlsf tlsf { heap_region, sizeof(heap_region) };
+    return tlsf;
+}
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    const InterruptLock lock;
+    auto result = heap().try_allocate(size, alignment);
+    return result.is_ok() ? result.unwrap() : nullptr;
+}
+
+// The allocator requires a power of two alignment.
+void* allocate_aligned(std::size_t size, std::size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    return allocate(size, alignment);
+}
+
+void deallocate(void* ptr) {
+    const InterruptLock lock;
+    heap().free(ptr);
+}
+
+void* reallocate(void* ptr, std::size_t size) {
+    if (ptr == nullptr) {
+        return allocate(size, ccl::Tlsf::alignment_min);
+    }
+    const std::size_t usable = ccl::Tlsf::usable_size(ptr);
+    if (size <= usable) {
+        return ptr;
+    }
+    void* moved = allocate(size, ccl::Tlsf::alignment_min);
+    if (moved != nullptr) {
+        std::memcpy(moved, ptr, usable);
+        deallocate(ptr);
+    }
+    return moved;
+}
+
+void* allocate_zeroed(std::size_t count, std::size_t size) {
+    std::size_t total;
+    if (__builtin_mul_overflow(count, size, &total)) {
+        return nullptr;
+    }
+    void* ptr = allocate(total, ccl::Tlsf::alignment_min);
+    if (ptr != nullptr) {
+        std::memset(ptr, 0, total);
+    }
+    return ptr;
+}
+
+void* allocate_or_panic(std::size_t size, std::size_t alignment) {
+    void* ptr = allocate(size, alignment);
+    if (ptr == nullptr) {
+        ccl::panic("Out of heap memory");
+    }
+    return ptr;
+}
+
+}  // namespace
+
+ccl::Tlsf::Stats heap_stats() {
+    const InterruptLock lock;
+    return heap().stats();
+}
+
+}  // namespace obc
+
+struct _reent;
+
+extern "C" {
+
+void* malloc(std::size_t size) {
+    return obc::allocate(size, ccl::Tlsf::alignment_min);
+}
+
+void free(void* ptr) {
+    obc::deallocate(ptr);
+}
+
+void* realloc(void* ptr, std::size_t size) {
+    return obc::reallocate(ptr, size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    return obc::allocate_zeroed(count, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) {
+    return obc::allocate_aligned(size, alignment);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) {
+    return obc::allocate_aligned(size, alignment);
+}
+
+void* _malloc_r(_reent* /*reent*/, std::size_t size) {
+    return obc::allocate(size, ccl::Tlsf::alignment_min);
+}
+
+void _free_r(_reent* /*reent*/, void* ptr) {
+    obc::deallocate(ptr);
+}
+
+void* _realloc_r(_reent* /*reent*/, void* ptr, std::size_t size) {
+    return obc::reallocate(ptr, size);
+}
+
+void* _calloc_r(_reent* /*reent*/, std::size_t count, std::size_t size) {
+    return obc::allocate_zeroed(count, size);
+}
+
+void* _memalign_r(_reent* /*reent*/, std::size_t alignment, std::size_t size) {
+    return obc::allocate_aligned(size, alignment);
+}
+
+}  // extern "C"
+
+void* operator new(std::size_t size) {
+    return obc::allocate_or_panic(size, ccl::Tlsf::alignment_min);
+}
+
+void* operator new[](std::size_t size) {
+    return obc::allocate_or_panic(size, ccl::Tlsf::alignment_min);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return obc::allocate_or_panic(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return obc::allocate_or_panic(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+    return obc::allocate(size, ccl::Tlsf::alignment_min);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+    return obc::allocate(size, ccl::Tlsf::alignment_min);
+}
+
+void operator delete(void* ptr) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t /*alignment*/) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete(
+    void* ptr,
+    std::size_t /*size*/,
+    std::align_val_t /*alignment*/
+) noexcept {
+    obc::deallocate(ptr);
+}
+
+void operator delete[](
+    void* ptr,
+    std::size_t /*size*/,
+    std::align_val_t /*alignment*/
+) noexcept {
+    obc::deallocate(ptr);
+}
@@ -0,0 +1,36 @@
+/// Bounded-time heap.
+///
+/// Replaces newlib's '_sbrk'-based allocator with a TLSF allocator over
+/// a static region of 'OBC_HEAP_SIZE' bytes in SRAM2. 'malloc', 'free' and
+/// their relatives, including the reentrant '_r' variants newlib uses
+/// internally, and all forms of 'operator new' and 'operator delete' are
+/// overridden, so every allocation takes constant time. Interrupts are
+/// masked for the duration of each call, allocating from interrupts is
+/// therefore possible but still discouraged.
+///
+/// 'operator new' panics when the heap is exhausted, the nothrow forms and
+/// 'malloc' return null.
+///
+/// # Examples
+///
+/// ```
+/// const ccl::Tlsf::Stats stats = obc::heap_stats();
+/// const std::size_t fragmented = stats.free - stats.largest_free;
+/// ```
+
+#ifndef OBC_HEAP_HPP
+#define OBC_HEAP_HPP
+
+#include <ccl/tlsf.hpp>
+
+#ifndef OBC_HEAP_SIZE
+#define OBC_HEAP_SIZE (16 * 1024)
+#endif
+
+namespace obc {
+
+ccl::Tlsf::Stats heap_stats();
+
+}  // namespace obc
+
+#endif
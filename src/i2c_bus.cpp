@@ -0,0 +1,57 @@
+#include "i2c_bus.hpp"
+
+#include <cstdint>
+
+#include "hal_callbacks.hpp"
+
+using namespace ccl::prelude;
+
+namespace obc {
+
+Result<ccl::Unit, HAL_StatusTypeDef> I2cDmaBus::start() {
+    if (hal::i2c_transfer_complete.is_bound(hi2c_)) {
+        return Err { HAL_BUSY };
+    }
+
+    const bool bound =
+        hal::i2c_transfer_complete.try_bind(hi2c_, [this] { done_(true); })
+            .is_ok()
+        && hal::i2c_error.try_bind(hi2c_, [this] { done_(false); }).is_ok();
+    if (!bound) {
+        hal::i2c_transfer_complete.unbind(hi2c_);
+        hal::i2c_error.unbind(hi2c_);
+        return Err { HAL_ERROR };
+    }
+    return Ok { ccl::Unit {} };
+}
+
+bool I2cDmaBus::begin(const ccl::I2cTransfer& transfer) {
+    if (transfer.data.size() > UINT16_MAX) {
+        return false;
+    }
+    // The HAL expects the 7-bit address in bits 7:1.
+    const auto address = static_cast<uint16_t>(transfer.address << 1);
+    const auto size = static_cast<uint16_t>(transfer.data.size());
+    if (transfer.direction == ccl::I2cTransfer::Direction::Read) {
+        return HAL_I2C_Mem_Read_DMA(
+                   hi2c_,
+                   address,
+                   transfer.reg,
+                   I2C_MEMADD_SIZE_8BIT,
+                   transfer.data.data(),
+                   size
+               )
+               == HAL_OK;
+    }
+    return HAL_I2C_Mem_Write_DMA(
+               hi2c_,
+               address,
+               transfer.reg,
+               I2C_MEMADD_SIZE_8BIT,
+               transfer.data.data(),
+               size
+           )
+           == HAL_OK;
+}
+
+}  // namespace obc
@@ -0,0 +1,75 @@
+/// I2C bus driven by DMA for 'ccl::I2cEngine'.
+///
+/// 'I2cDmaBus' runs each transfer as a HAL register access in DMA mode:
+/// the address and register phases are handled by the I2C interrupt, the
+/// data by the DMA controller. The engine is notified from the HAL memory
+/// transfer complete and error callbacks, which start the next transfer, so
+/// a batch runs without the main loop.
+///
+/// Transfers with no data or more than 65535 bytes are not supported by the
+/// HAL and fail to start.
+///
+/// # Examples
+///
+/// ```
+/// I2cDmaBus bus { &hi2c1 };
+/// bus.start().expect("Cannot start I2C");
+/// I2cEngine engine { bus };
+/// ```
+
+#ifndef OBC_I2C_BUS_HPP
+#define OBC_I2C_BUS_HPP
+
+#include <ccl/i2c_engine.hpp>
+#include <ccl/inplace_function.hpp>
+#include <ccl/result.hpp>
+
+#include "hal_status.hpp"
+#include "interrupt_lock.hpp"
+#include "stm32l4xx_hal.h"
+#include "systick_clock.hpp"
+
+// See 'hal_status.hpp'.
+static_assert(
+    sizeof(ccl::Result<ccl::Unit, HAL_StatusTypeDef>)
+        == sizeof(HAL_StatusTypeDef),
+    "HAL_StatusTypeDef must use HAL_OK as its niche"
+);
+
+namespace obc {
+
+class I2cDmaBus {
+   public:
+    using Done = ccl::InplaceFunction<void(bool)>;
+
+    explicit I2cDmaBus(I2C_HandleTypeDef* hi2c) : hi2c_ { hi2c } {}
+
+    I2cDmaBus(const I2cDmaBus&) = delete;
+    I2cDmaBus(I2cDmaBus&&) = delete;
+    I2cDmaBus& operator=(const I2cDmaBus&) = delete;
+    I2cDmaBus& operator=(I2cDmaBus&&) = delete;
+    ~I2cDmaBus() = default;
+
+    /// Binds the HAL callbacks. Only one bus per I2C handle may be started.
+    ccl::Result<ccl::Unit, HAL_StatusTypeDef> start();
+
+    void bind(Done done) {
+        done_ = done;
+    }
+
+    bool begin(const ccl::I2cTransfer& transfer);
+
+    I2C_HandleTypeDef* handle() const {
+        return hi2c_;
+    }
+
+   private:
+    I2C_HandleTypeDef* hi2c_;
+    Done done_;
+};
+
+using I2cEngine = ccl::I2cEngine<I2cDmaBus, SysTickClock, InterruptLock>;
+
+}  // namespace obc
+
+#endif
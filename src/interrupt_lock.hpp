@@ -0,0 +1,47 @@
+/// Critical section that masks interrupts.
+///
+/// 'InterruptLock' masks all configurable interrupts for its lifetime and
+/// restores the previous mask afterwards, so locks may be nested and taken
+/// from interrupts. Keep the locked sections short, they add to the
+/// latency of every interrupt.
+///
+/// # Examples
+///
+/// ```
+/// {
+///     const InterruptLock lock;
+///     shared = value;
+/// }
+/// ```
+
+#ifndef OBC_INTERRUPT_LOCK_HPP
+#define OBC_INTERRUPT_LOCK_HPP
+
+#include <cstdint>
+
+#include "stm32l4xx_hal.h"
+
+namespace obc {
+
+class InterruptLock {
+   public:
+    InterruptLock() : primask_ { __get_PRIMASK() } {
+        __disable_irq();
+    }
+
+    InterruptLock(const InterruptLock&) = delete;
+    InterruptLock(InterruptLock&&) = delete;
+    InterruptLock& operator=(const InterruptLock&) = delete;
+    InterruptLock& operator=(InterruptLock&&) = delete;
+
+    ~InterruptLock() {
+        __set_PRIMASK(primask_);
+    }
+
+   private:
+    uint32_t primask_;
+};
+
+}  // namespace obc
+
+#endif
@@ -0,0 +1,69 @@
+#include "irq_monitor.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "interrupt_lock.hpp"
+#include "systick_clock.hpp"
+
+namespace obc {
+
+namespace {
+
+// Exceptions start at -16.
+constexpr int32_t first_irq = -16;
+constexpr std::size_t irq_count = FPU_IRQn - first_irq + 1;
+
+ccl::IrqMonitor<max_monitored_irqs, SysTickClock, InterruptLock> monitor;
+
+// Slot + 1 of each interrupt, 0 until it runs for the first time.
+std::array<uint8_t, irq_count> slots {};
+std::array<IRQn_Type, max_monitored_irqs> irqs {};
+std::atomic<std::size_t> slot_count = 0;
+
+std::size_t slot_of(IRQn_Type irq) {
+    const auto index = static_cast<std::size_t>(irq - first_irq);
+    if (slots[index] == 0) {
+        // Handlers of higher priority may take a slot meanwhile.
+        const InterruptLock lock;
+        const std::size_t slot = slot_count.load(std::memory_order_relaxed);
+        if (slot == max_monitored_irqs) {
+            ccl::panic("Too many monitored interrupts");
+        }
+        irqs[slot] = irq;
+        slots[index] = static_cast<uint8_t>(slot + 1);
+        slot_count.store(slot + 1, std::memory_order_release);
+    }
+    return slots[index] - 1U;
+}
+
+}  // namespace
+
+std::size_t monitored_irqs() {
+    return slot_count.load(std::memory_order_acquire);
+}
+
+IRQn_Type monitored_irq(std::size_t slot) {
+    return irqs[slot];
+}
+
+ccl::IrqStats take_irq_stats(std::size_t slot) {
+    return monitor.take(slot);
+}
+
+}  // namespace obc
+
+/// Called at the start of a handler in 'stm32l4xx_it.c'.
+extern "C" void obc_irq_enter(IRQn_Type irq) {
+    uint32_t latency = 0;
+    if (irq == SysTick_IRQn) {
+        latency = SysTick->LOAD - SysTick->VAL;
+    }
+    obc::monitor.enter(obc::slot_of(irq), latency);
+}
+
+/// Called at the end of a handler in 'stm32l4xx_it.c'.
+extern "C" void obc_irq_exit() {
+    obc::monitor.exit();
+}
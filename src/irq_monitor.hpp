@@ -0,0 +1,43 @@
+/// Interrupt handler instrumentation.
+///
+/// With the 'OBC_IRQ_MONITOR' build option the handlers in
+/// 'stm32l4xx_it.c' call 'obc_irq_enter' and 'obc_irq_exit', which record
+/// them in a 'ccl::IrqMonitor' measuring in core cycles. Each handler gets
+/// a slot the first time it runs. Without the option the hooks compile to
+/// nothing and no handler is ever seen.
+///
+/// The entry latency is only known for SysTick, from the counter value
+/// since its reload. It includes the 12 cycles of exception entry.
+///
+/// # Examples
+///
+/// ```
+/// for (std::size_t slot = 0; slot < obc::monitored_irqs(); ++slot) {
+///     const ccl::IrqStats stats = obc::take_irq_stats(slot);
+///     report(obc::monitored_irq(slot), stats);
+/// }
+/// ```
+
+#ifndef OBC_IRQ_MONITOR_HPP
+#define OBC_IRQ_MONITOR_HPP
+
+#include <ccl/irq_monitor.hpp>
+#include <cstddef>
+
+#include "stm32l4xx_hal.h"
+
+namespace obc {
+
+constexpr std::size_t max_monitored_irqs = 12;
+
+/// Number of handlers that have run since reset.
+std::size_t monitored_irqs();
+
+IRQn_Type monitored_irq(std::size_t slot);
+
+/// Returns the stats of the handler in 'slot' since the last call.
+ccl::IrqStats take_irq_stats(std::size_t slot);
+
+}  // namespace obc
+
+#endif
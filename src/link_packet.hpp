@@ -0,0 +1,121 @@
+/// Packet framing of the USART2 ground link.
+///
+/// The binary log, the echoed text, crash reports and profile frames share
+/// USART2. Each is sent in packets whose first byte is its 'LinkChannel',
+/// COBS encoded and terminated by a zero byte, see 'ccl::CobsWriter'. The
+/// ground splits the stream at the zero bytes and dispatches on the
+/// channel, see 'script/uart_link.py', so binary frames and arbitrary text
+/// cannot be mistaken for each other and a receiver that starts listening
+/// mid-stream resynchronizes at the next packet.
+///
+/// A 'LinkPacket<MaxPayload>' owns the buffer of one packet in flight. A
+/// packet the transmit queue has no room for stays pending and is sent
+/// again by 'flush'.
+///
+/// # Examples
+///
+/// ```
+/// LinkPacket<64> packet;
+///
+/// if (packet.ready(tx)) {
+///     ccl::CobsWriter writer = packet.start(LinkChannel::Text);
+///     writer.write(text);
+///     packet.finish(tx, writer).expect("Text too long");
+/// }
+/// ```
+
+#ifndef OBC_LINK_PACKET_HPP
+#define OBC_LINK_PACKET_HPP
+
+#include <array>
+#include <ccl/bounds_error.hpp>
+#include <ccl/cobs.hpp>
+#include <ccl/result.hpp>
+#include <ccl/span.hpp>
+#include <ccl/try.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#include "uart_tx.hpp"
+
+namespace obc {
+
+/// First byte of each packet, must match 'script/uart_link.py'.
+enum class LinkChannel : uint8_t {
+    /// 'ccl::log_buffer' frames, only whole ones.
+    Log = 1,
+    /// Echoed input and crash reports.
+    Text = 2,
+    /// 'ccl::ProfileTable' frames.
+    Profile = 3,
+};
+
+template <std::size_t MaxPayload>
+class LinkPacket {
+   public:
+    /// Bytes after the channel.
+    static constexpr std::size_t max_payload = MaxPayload;
+
+    LinkPacket() = default;
+
+    LinkPacket(const LinkPacket&) = delete;
+    LinkPacket(LinkPacket&&) = delete;
+    LinkPacket& operator=(const LinkPacket&) = delete;
+    LinkPacket& operator=(LinkPacket&&) = delete;
+    ~LinkPacket() = default;
+
+    /// Retries a pending packet. Returns whether none is pending anymore,
+    /// i.e. later packets will be transmitted after this one.
+    bool flush(UartTx& tx) {
+        if (pending_.size() == 0) {
+            return true;
+        }
+        if (auto ticket = tx.send({ { pending_.data(), pending_.size() } })
+                              .ok()) {
+            ticket_ = *ticket;
+            pending_ = {};
+            return true;
+        }
+        return false;
+    }
+
+    /// Whether the buffer may be reused for the next packet, flushing it
+    /// first if needed.
+    bool ready(UartTx& tx) {
+        return flush(tx) && is_sent(tx);
+    }
+
+    /// Whether the last packet left the UART.
+    bool is_sent(const UartTx& tx) const {
+        return pending_.size() == 0 && tx.is_sent(ticket_);
+    }
+
+    /// Starts encoding the next packet into the buffer. Must only be called
+    /// when 'ready'.
+    ccl::CobsWriter start(LinkChannel channel) {
+        ccl::CobsWriter writer { buffer_ };
+        writer.write(static_cast<uint8_t>(channel));
+        return writer;
+    }
+
+    /// Terminates the packet written to 'writer' and queues it, or keeps it
+    /// pending if the queue is full. Fails if more than 'max_payload' bytes
+    /// were written; nothing is sent then.
+    ccl::Result<ccl::Unit, ccl::BoundsError> finish(
+        UartTx& tx,
+        ccl::CobsWriter& writer
+    ) {
+        pending_ = CCL_TRY(writer.finish());
+        flush(tx);
+        return ccl::Ok { ccl::Unit {} };
+    }
+
+   private:
+    std::array<uint8_t, ccl::max_cobs_size(MaxPayload + 1) + 1> buffer_ {};
+    ccl::Span<uint8_t> pending_ {};
+    uint32_t ticket_ = 0;
+};
+
+}  // namespace obc
+
+#endif
@@ -0,0 +1,96 @@
+/// GPIO pin known at compile time.
+///
+/// 'Pin<Port, N>' is a type for pin 'N' of a GPIO port. The port address
+/// and the pin mask are constants, so 'set', 'clear' and 'write' compile to
+/// a single store to BSRR and 'toggle' to a load of ODR followed by a store
+/// to BSRR. BSRR writes only affect the addressed pin, no read-modify-write
+/// of ODR is needed and interrupts changing other pins of the same port
+/// cannot be lost.
+///
+/// Pins are configured by the CubeMX generated 'MX_GPIO_Init', 'Pin' only
+/// drives and reads them.
+///
+/// # Examples
+///
+/// ```
+/// using Led = Pin<Port::A, 5>;
+///
+/// Led::set();
+/// Led::toggle();
+/// ```
+
+#ifndef OBC_PIN_HPP
+#define OBC_PIN_HPP
+
+#include <cstdint>
+
+#include "stm32l4xx_hal.h"
+
+namespace obc {
+
+enum class Port : uintptr_t {
+    A = GPIOA_BASE,
+    B = GPIOB_BASE,
+    C = GPIOC_BASE,
+    D = GPIOD_BASE,
+    E = GPIOE_BASE,
+    F = GPIOF_BASE,
+    G = GPIOG_BASE,
+    H = GPIOH_BASE,
+};
+
+/// Port and mask of a pin, comparable in constant expressions.
+struct PinId {
+    Port port;
+    uint16_t mask;
+
+    friend constexpr bool operator==(PinId lhs, PinId rhs) {
+        return lhs.port == rhs.port && lhs.mask == rhs.mask;
+    }
+
+    friend constexpr bool operator!=(PinId lhs, PinId rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template <Port P, unsigned N>
+struct Pin {
+    static_assert(N < 16, "GPIO ports have 16 pins");
+
+    static constexpr uint32_t mask = 1U << N;
+    static constexpr PinId id { P, static_cast<uint16_t>(mask) };
+
+    static GPIO_TypeDef* gpio() {
+        return reinterpret_cast<GPIO_TypeDef*>(static_cast<uintptr_t>(P));
+    }
+
+    static void set() {
+        gpio()->BSRR = mask;
+    }
+
+    static void clear() {
+        gpio()->BSRR = mask << 16;
+    }
+
+    static void write(bool high) {
+        gpio()->BSRR = high ? mask : mask << 16;
+    }
+
+    static void toggle() {
+        gpio()->BSRR = (gpio()->ODR & mask) != 0 ? mask << 16 : mask;
+    }
+
+    /// Input level.
+    static bool read() {
+        return (gpio()->IDR & mask) != 0;
+    }
+
+    /// Output level last written.
+    static bool is_set() {
+        return (gpio()->ODR & mask) != 0;
+    }
+};
+
+}  // namespace obc
+
+#endif
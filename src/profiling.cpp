@@ -0,0 +1,7 @@
+#include "profiling.hpp"
+
+namespace obc {
+
+ccl::ProfileTable<max_profile_zones, InterruptLock> profiles;
+
+}  // namespace obc
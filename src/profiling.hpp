@@ -0,0 +1,40 @@
+/// Execution time profiling with the DWT cycle counter.
+///
+/// 'ProfileZone' measures in core cycles, see 'ccl::ProfileZone'. The
+/// counter stops in stop mode and its frequency changes with the operating
+/// point of 'ClockManager', so zones must not span an idle wait or a
+/// switch. Zones are registered in 'profiles', which 'run' sends over the
+/// UART periodically.
+///
+/// # Examples
+///
+/// ```
+/// ccl::ProfileStats filter_profile { "filter" };
+///
+/// obc::profiles.try_add(filter_profile).expect("Too many profile zones");
+/// {
+///     const obc::ProfileZone zone { filter_profile };
+///     run_filter();
+/// }
+/// ```
+
+#ifndef OBC_PROFILING_HPP
+#define OBC_PROFILING_HPP
+
+#include <ccl/profile.hpp>
+#include <cstddef>
+
+#include "interrupt_lock.hpp"
+#include "systick_clock.hpp"
+
+namespace obc {
+
+constexpr std::size_t max_profile_zones = 8;
+
+using ProfileZone = ccl::ProfileZone<SysTickClock>;
+
+extern ccl::ProfileTable<max_profile_zones, InterruptLock> profiles;
+
+}  // namespace obc
+
+#endif
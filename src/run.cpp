@@ -1,9 +1,294 @@
 #include "run.hpp"
 
+#include <array>
+#include <ccl/cobs.hpp>
+#include <ccl/log.hpp>
 #include <ccl/result.hpp>
+#include <ccl/scheduler.hpp>
+#include <ccl/try.hpp>
+#include <iterator>
+
+#include "board_pins.hpp"
+#include "clock_manager.hpp"
+#include "crash_record.hpp"
+#include "i2c_bus.hpp"
+#include "irq_monitor.hpp"
+#include "link_packet.hpp"
+#include "profiling.hpp"
+#include "tickless_clock.hpp"
+#include "timers.hpp"
+#include "uart_rx.hpp"
+#include "uart_tx.hpp"
 
 using namespace ccl::prelude;
 
+namespace {
+
+obc::UartRx* uart_rx = nullptr;
+obc::UartTx* uart_tx = nullptr;
+obc::I2cEngine* i2c = nullptr;
+
+// A drain returns at most the capacity of the receive ring.
+obc::LinkPacket<obc::UartRx::capacity> echo_packet;
+ccl::ProfileStats echo_profile { "uart_echo" };
+
+bool has_input() {
+    return uart_rx->available() > 0 && echo_packet.is_sent(*uart_tx);
+}
+
+void echo_uart() {
+    const obc::ProfileZone zone { echo_profile };
+    // The queue is shared with the log and the reports, keep the input
+    // while it is full.
+    if (!echo_packet.ready(*uart_tx)) {
+        return;
+    }
+    ccl::CobsWriter writer = echo_packet.start(obc::LinkChannel::Text);
+    std::size_t size = 0;
+    uart_rx->drain([&](const uint8_t* data, std::size_t chunk) {
+        writer.write({ data, chunk });
+        size += chunk;
+    });
+    if (size > 0) {
+        echo_packet.finish(*uart_tx, writer).expect("Echo packet too small");
+    }
+}
+
+obc::LinkPacket<192> crash_packet;
+
+// Log frames are at most 256 bytes, see 'ccl::detail::log'.
+obc::LinkPacket<256> log_packet;
+
+void flush_log() {
+    // The crash report goes out before the log of the new run.
+    if (!crash_packet.flush(*uart_tx) || !log_packet.ready(*uart_tx)) {
+        return;
+    }
+    ccl::CobsWriter writer = log_packet.start(obc::LinkChannel::Log);
+    std::size_t size = 0;
+    // Published frames are complete. Only whole frames go in a packet so
+    // the ground can decode each packet on its own.
+    for (auto chunk = ccl::log_buffer.peek(); chunk.size > 0;
+         chunk = ccl::log_buffer.peek()) {
+        const std::size_t frame = 1U + chunk.data[0];
+        if (size + frame > log_packet.max_payload) {
+            break;
+        }
+        size += frame;
+        // A frame may wrap around the end of the ring.
+        for (std::size_t left = frame; left > 0;) {
+            chunk = ccl::log_buffer.peek();
+            const std::size_t part = left < chunk.size ? left : chunk.size;
+            writer.write({ chunk.data, part });
+            ccl::log_buffer.consume(part);
+            left -= part;
+        }
+    }
+    if (size > 0) {
+        log_packet.finish(*uart_tx, writer).expect("Log packet too small");
+    }
+}
+
+void run_timers() {
+    obc::timers.run_deferred();
+}
+
+bool has_deferred_timers() {
+    return obc::timers.has_deferred();
+}
+
+// Identification registers of the accelerometer and the temperature
+// sensor, read as a bus health check until their drivers use the engine.
+std::array<uint8_t, 1> accel_id {};
+std::array<uint8_t, 2> temperature_config {};
+ccl::I2cTransfer sensor_transfers[] = {
+    ccl::I2cTransfer::read(0x6A, 0x0F, accel_id),
+    ccl::I2cTransfer::read(0x48, 0x01, temperature_config),
+};
+
+// Whether each device answered its last read. Only changes are logged, so
+// a missing device is reported once instead of on every poll. Failed
+// transfers are also counted in the I2C stats.
+bool sensor_responds[std::size(sensor_transfers)] = { true, true };
+
+// Called in the I2C interrupt, logging is interrupt safe.
+void check_sensors(ccl::I2cBatch& batch) {
+    const ccl::Span<ccl::I2cTransfer> transfers = batch.transfers();
+    for (std::size_t i = 0; i < transfers.size(); ++i) {
+        const bool responds =
+            transfers[i].status == ccl::I2cTransfer::Status::Ok;
+        if (responds == sensor_responds[i]) {
+            continue;
+        }
+        sensor_responds[i] = responds;
+        if (responds) {
+            CCL_LOG_INFO(
+                "I2C device 0x%02hhx responds again",
+                transfers[i].address
+            );
+        } else {
+            CCL_LOG_WARN(
+                "I2C device 0x%02hhx does not respond",
+                transfers[i].address
+            );
+        }
+    }
+}
+
+ccl::I2cBatch sensor_batch { sensor_transfers, check_sensors };
+
+void poll_sensors() {
+    if (!sensor_batch.is_pending()) {
+        i2c->submit(sensor_batch);
+    }
+}
+
+void report_i2c() {
+    const ccl::I2cStats stats = i2c->stats();
+    i2c->reset_stats();
+    if (stats.transfers == 0) {
+        return;
+    }
+    // DWT cycles, which stop in STOP1, see 'ccl::I2cEngine'.
+    const uint64_t busy_permille =
+        uint64_t { stats.busy_cycles } * 1000 / stats.window_cycles;
+    CCL_LOG_INFO(
+        "I2C: %lu transfers, %lu errors, %lu spurious, "
+        "%lu permille of active cycles busy, max batch latency %lu cycles",
+        static_cast<unsigned long>(stats.transfers),
+        static_cast<unsigned long>(stats.errors),
+        static_cast<unsigned long>(stats.spurious),
+        static_cast<unsigned long>(busy_permille),
+        static_cast<unsigned long>(stats.max_batch_latency_cycles)
+    );
+}
+
+// USART2 wakes the core up on input, see 'start_uart'. Input that arrived
+// just before is echoed first.
+bool can_stop() {
+    return uart_rx->available() == 0 && uart_tx->stats().bytes_pending == 0
+        && i2c->is_idle();
+}
+
+void report_power() {
+    const obc::TicklessClock::Stats stats = obc::TicklessClock::stats();
+    CCL_LOG_INFO(
+        "Power: %lu stops, %lu ms stopped, max wakeup %lu us",
+        static_cast<unsigned long>(stats.stops),
+        static_cast<unsigned long>(stats.stop_ms),
+        static_cast<unsigned long>(stats.max_wakeup_us)
+    );
+    if (stats.restore_failures > 0) {
+        CCL_LOG_ERROR(
+            "Clocks not restored after %lu stops, last status %d",
+            static_cast<unsigned long>(stats.restore_failures),
+            static_cast<int>(stats.last_restore_error)
+        );
+    }
+}
+
+void report_irqs() {
+    for (std::size_t slot = 0; slot < obc::monitored_irqs(); ++slot) {
+        const ccl::IrqStats stats = obc::take_irq_stats(slot);
+        if (stats.runs == 0) {
+            continue;
+        }
+        CCL_LOG_INFO(
+            "IRQ %d: %lu runs, %llu cycles, max %lu cycles, "
+            "max latency %lu cycles, %lu preempted",
+            static_cast<int>(obc::monitored_irq(slot)),
+            static_cast<unsigned long>(stats.runs),
+            static_cast<unsigned long long>(stats.total_cycles),
+            static_cast<unsigned long>(stats.max_cycles),
+            static_cast<unsigned long>(stats.max_latency_cycles),
+            static_cast<unsigned long>(stats.preempted)
+        );
+    }
+}
+
+std::array<uint8_t, 512> profile_frame {};
+obc::LinkPacket<profile_frame.size()> profile_packet;
+
+void send_profiles() {
+    if (!profile_packet.ready(*uart_tx)) {
+        return;
+    }
+    ccl::ByteWriter frame { profile_frame };
+    if (obc::profiles.serialize(frame).is_err()) {
+        CCL_LOG_WARN("Profile frame too small");
+        return;
+    }
+    ccl::CobsWriter writer = profile_packet.start(obc::LinkChannel::Profile);
+    writer.write(frame.written());
+    profile_packet.finish(*uart_tx, writer).expect("Profile packet too small");
+}
+
+void blink_led() {
+    obc::board::Led::toggle();
+}
+
+// The echo and the deferred timers run as soon as they have work, their
+// periods only retry a full transmit queue and bound the idle time.
+constexpr ccl::Task tasks[] = {
+    { "uart_echo", echo_uart, 10, 0, 0, has_input },
+    { "timers", run_timers, 1000, 0, 0, has_deferred_timers },
+    { "led", blink_led, 1000, 0, 1 },
+    { "log", flush_log, 10, 0, 2 },
+    { "sensors", poll_sensors, 100, 50, 2 },
+    { "i2c_stats", report_i2c, 10000, 7500, 3 },
+    { "power_stats", report_power, 10000, 0, 3 },
+    { "profiles", send_profiles, 10000, 5000, 3 },
+    { "irq_stats", report_irqs, 10000, 2500, 3 },
+};
+
+static_assert(ccl::is_valid_schedule(tasks));
+
+Result<ccl::Unit, HAL_StatusTypeDef> start_uart(UART_HandleTypeDef* huart) {
+    static obc::UartRx rx { huart };
+    static obc::UartTx tx { huart };
+    CCL_TRY(obc::TicklessClock::enable_uart_wakeup(huart));
+    CCL_TRY(rx.start());
+    CCL_TRY(tx.start());
+    // The wakeup runs the UART on HSI16, so it needs no 'retune_uart'.
+    uart_rx = &rx;
+    uart_tx = &tx;
+    return Ok { ccl::Unit {} };
+}
+
+Result<ccl::Unit, HAL_StatusTypeDef> start_i2c(I2C_HandleTypeDef* hi2c) {
+    static obc::I2cDmaBus bus { hi2c };
+    CCL_TRY(bus.start());
+    static obc::I2cEngine engine { bus };
+    obc::ClockManager::try_subscribe([hi2c](obc::OperatingPoint point) {
+        obc::retune_i2c(hi2c, point);
+    }).expect("Too many clock listeners");
+    i2c = &engine;
+    return Ok { ccl::Unit {} };
+}
+
+void report_boot() {
+    // Time from reset until the application is running.
+    const uint32_t boot_ms = HAL_GetTick();
+    if (auto record = obc::take_crash_record()) {
+        std::array<char, crash_packet.max_payload> report {};
+        const std::size_t size = obc::format_crash_record(
+            *record,
+            boot_ms,
+            report.data(),
+            report.size()
+        );
+        ccl::CobsWriter writer = crash_packet.start(obc::LinkChannel::Text);
+        writer.write({ reinterpret_cast<const uint8_t*>(report.data()), size });
+        crash_packet.finish(*uart_tx, writer).expect("Crash packet too small");
+    }
+    CCL_LOG_INFO(
+        "Running %lu ms after reset",
+        static_cast<unsigned long>(boot_ms)
+    );
+}
+
+}  // namespace
+
 Result<int, int> result_example(bool success) {
     if (success) {
         return Ok { 1 };
@@ -14,8 +299,24 @@ Result<int, int> result_example(bool success) {
 
 void run(HardwareHandles handles) {
     result_example(true).unwrap();
-    while (true) {
-        HAL_GPIO_TogglePin(handles.led_gpio_port, handles.led_pin);
-        HAL_Delay(1000);
+
+    obc::ClockManager::init();
+    obc::TicklessClock::init();
+    obc::profiles.try_add(obc::timer_tick_profile)
+        .expect("Too many profile zones");
+    obc::profiles.try_add(echo_profile).expect("Too many profile zones");
+
+    start_uart(handles.uart).expect("Cannot start UART");
+    start_i2c(handles.i2c).expect("Cannot start I2C");
+    report_boot();
+
+    obc::TicklessClock::set_stop_guard(can_stop);
+    if (obc::TicklessClock::start().is_err()) {
+        CCL_LOG_WARN("LSE did not start, idling without stop mode");
     }
+
+    static ccl::Scheduler<obc::TicklessClock, std::size(tasks)> scheduler {
+        tasks
+    };
+    scheduler.run();
 }
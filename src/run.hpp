@@ -9,8 +9,7 @@ extern "C" {
 
 struct HardwareHandles {
     UART_HandleTypeDef* uart;
-    GPIO_TypeDef* led_gpio_port;
-    uint16_t led_pin;
+    I2C_HandleTypeDef* i2c;
 };
 
 void run(struct HardwareHandles handles);
@@ -19,4 +18,4 @@ void run(struct HardwareHandles handles);
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+/// Scheduler clock backed by the HAL SysTick tick.
+///
+/// Time is counted in milliseconds by 'HAL_IncTick' in 'SysTick_Handler',
+/// execution time is measured with the DWT cycle counter. While waiting the
+/// core sleeps in WFI and is woken up by the next interrupt, at the latest
+/// by the following SysTick.
+
+#ifndef OBC_SYSTICK_CLOCK_HPP
+#define OBC_SYSTICK_CLOCK_HPP
+
+#include <cstdint>
+
+#include "stm32l4xx_hal.h"
+
+namespace obc {
+
+struct SysTickClock {
+    /// Enables the DWT cycle counter.
+    static void init() {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    static uint32_t now() {
+        return HAL_GetTick();
+    }
+
+    static uint32_t cycles() {
+        return DWT->CYCCNT;
+    }
+
+    static void idle_until(uint32_t deadline) {
+        // With interrupts masked an interrupt arriving after the check still
+        // wakes the core up, so no tick can be missed.
+        __disable_irq();
+        if (static_cast<int32_t>(HAL_GetTick() - deadline) < 0) {
+            __WFI();
+        }
+        __enable_irq();
+    }
+};
+
+}  // namespace obc
+
+#endif
@@ -0,0 +1,235 @@
+#include "tickless_clock.hpp"
+
+#include <ccl/tickless.hpp>
+
+#include "clock_manager.hpp"
+#include "interrupt_lock.hpp"
+#include "systick_clock.hpp"
+#include "timers.hpp"
+
+using namespace ccl::prelude;
+
+namespace obc {
+
+namespace {
+
+constexpr uint32_t lse_hz = 32768;
+constexpr uint32_t tick_hz = 1000;
+
+// Stops shorter than a few ticks save less than restarting the PLL costs.
+// LPTIM1 wraps after 2 s.
+constexpr IdlePolicy policy { 5, 1900, 1 };
+
+bool started = false;
+bool (*stop_guard)() = nullptr;
+UART_HandleTypeDef* wakeup_uart = nullptr;
+TickCompensator compensator { lse_hz, tick_hz };
+TicklessClock::Stats counters {};
+
+uint16_t read_counter() {
+    // CNT is clocked by the LSE, a read is only reliable if it matches the
+    // following one.
+    uint32_t count = LPTIM1->CNT;
+    while (true) {
+        const uint32_t again = LPTIM1->CNT;
+        if (again == count) {
+            return static_cast<uint16_t>(count);
+        }
+        count = again;
+    }
+}
+
+// Returns the counter once it has advanced. Stops start and end on a count,
+// so no fractions of a count are lost between them.
+uint16_t next_count() {
+    const uint16_t count = read_counter();
+    while (true) {
+        const uint16_t next = read_counter();
+        if (next != count) {
+            return next;
+        }
+    }
+}
+
+void set_compare(uint16_t value) {
+    LPTIM1->CMP = value;
+    while ((LPTIM1->ISR & LPTIM_ISR_CMPOK) == 0) {
+    }
+    // Drop a match of the previous compare value.
+    LPTIM1->ICR = LPTIM_ICR_CMPOKCF | LPTIM_ICR_CMPMCF;
+    NVIC_ClearPendingIRQ(LPTIM1_IRQn);
+}
+
+// Called with interrupts masked. The LPTIM1 interrupt still ends the stop
+// and runs once interrupts are unmasked.
+void stop(uint32_t ticks) {
+    const uint16_t start = next_count();
+    // The part of the current tick that has elapsed is lost when SysTick
+    // restarts.
+    compensator.add_fraction(SysTick->LOAD - SysTick->VAL, SysTick->LOAD + 1);
+    const uint32_t counts = compensator.counts_for(ticks);
+    set_compare(static_cast<uint16_t>(start + counts));
+
+    HAL_SuspendTick();
+    if (wakeup_uart != nullptr) {
+        // Set only while stopped, it makes the UART raise its wakeup
+        // interrupt for every byte.
+        SET_BIT(wakeup_uart->Instance->CR1, USART_CR1_UESM);
+        HAL_PWREx_EnterSTOP1Mode(PWR_STOPENTRY_WFI);
+        CLEAR_BIT(wakeup_uart->Instance->CR1, USART_CR1_UESM);
+    } else {
+        HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+    }
+    if (auto error = ClockManager::restore().err()) {
+        ++counters.restore_failures;
+        counters.last_restore_error = *error;
+    }
+    const auto elapsed = static_cast<uint16_t>(next_count() - start);
+    // Start the first tick after the stop on the count as well.
+    HAL_InitTick(uwTickPrio);
+
+    const uint32_t missed = compensator.elapsed_ticks(elapsed);
+    uwTick += missed;
+    for (uint32_t i = 0; i < missed; ++i) {
+        timers.tick();
+    }
+
+    ++counters.stops;
+    counters.stop_ms += missed;
+    // Earlier wakeups are caused by other interrupts.
+    if (elapsed >= counts) {
+        const uint32_t latency_us = (elapsed - counts) * 1'000'000 / lse_hz;
+        counters.last_wakeup_us = latency_us;
+        if (latency_us > counters.max_wakeup_us) {
+            counters.max_wakeup_us = latency_us;
+        }
+    }
+}
+
+}  // namespace
+
+void TicklessClock::init() {
+    SysTickClock::init();
+}
+
+Result<ccl::Unit, HAL_StatusTypeDef> TicklessClock::start() {
+    RCC_OscInitTypeDef osc {};
+    osc.OscillatorType = RCC_OSCILLATORTYPE_LSE;
+    osc.LSEState = RCC_LSE_ON;
+    osc.PLL.PLLState = RCC_PLL_NONE;
+    HAL_StatusTypeDef status = HAL_RCC_OscConfig(&osc);
+    if (status != HAL_OK) {
+        return Err { status };
+    }
+
+    RCC_PeriphCLKInitTypeDef clock {};
+    clock.PeriphClockSelection = RCC_PERIPHCLK_LPTIM1;
+    clock.Lptim1ClockSelection = RCC_LPTIM1CLKSOURCE_LSE;
+    status = HAL_RCCEx_PeriphCLKConfig(&clock);
+    if (status != HAL_OK) {
+        return Err { status };
+    }
+    __HAL_RCC_LPTIM1_CLK_ENABLE();
+
+    // Free running over the full 16 bits. IER may only be written while
+    // the timer is disabled. The compare match also fires once per wrap
+    // while running, which is harmless.
+    LPTIM1->CFGR = 0;
+    LPTIM1->IER = LPTIM_IER_CMPMIE;
+    LPTIM1->CR = LPTIM_CR_ENABLE;
+    LPTIM1->ARR = 0xFFFF;
+    while ((LPTIM1->ISR & LPTIM_ISR_ARROK) == 0) {
+    }
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF;
+    LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_CNTSTRT;
+
+    EXTI->IMR2 |= EXTI_IMR2_IM32;
+    HAL_NVIC_SetPriority(LPTIM1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+
+#ifndef NDEBUG
+    // Keep the debug connection alive in stop mode.
+    HAL_DBGMCU_EnableDBGStopMode();
+#endif
+
+    started = true;
+    return Ok { ccl::Unit {} };
+}
+
+void TicklessClock::set_stop_guard(bool (*guard)()) {
+    const InterruptLock lock;
+    stop_guard = guard;
+}
+
+Result<ccl::Unit, HAL_StatusTypeDef> TicklessClock::enable_uart_wakeup(
+    UART_HandleTypeDef* huart
+) {
+    RCC_PeriphCLKInitTypeDef clock {};
+    if (huart->Instance == USART1) {
+        clock.PeriphClockSelection = RCC_PERIPHCLK_USART1;
+        clock.Usart1ClockSelection = RCC_USART1CLKSOURCE_HSI;
+    } else if (huart->Instance == USART2) {
+        clock.PeriphClockSelection = RCC_PERIPHCLK_USART2;
+        clock.Usart2ClockSelection = RCC_USART2CLKSOURCE_HSI;
+    } else if (huart->Instance == USART3) {
+        clock.PeriphClockSelection = RCC_PERIPHCLK_USART3;
+        clock.Usart3ClockSelection = RCC_USART3CLKSOURCE_HSI;
+    } else {
+        return Err { HAL_ERROR };
+    }
+    HAL_StatusTypeDef status = HAL_RCCEx_PeriphCLKConfig(&clock);
+    if (status != HAL_OK) {
+        return Err { status };
+    }
+    // Recomputes the baud rate divider for HSI16.
+    status = HAL_UART_Init(huart);
+    if (status != HAL_OK) {
+        return Err { status };
+    }
+    // Wake up once a byte is in the data register, the DMA reads it as soon
+    // as the core runs.
+    UART_WakeUpTypeDef wakeup {};
+    wakeup.WakeUpEvent = UART_WAKEUP_ON_READDATA_NONEMPTY;
+    status = HAL_UARTEx_StopModeWakeUpSourceConfig(huart, wakeup);
+    if (status != HAL_OK) {
+        return Err { status };
+    }
+    __HAL_UART_ENABLE_IT(huart, UART_IT_WUF);
+
+    const InterruptLock lock;
+    wakeup_uart = huart;
+    return Ok { ccl::Unit {} };
+}
+
+void TicklessClock::idle_until(uint32_t deadline) {
+    // With interrupts masked an interrupt arriving after the checks still
+    // wakes the core up, so no tick or event can be missed.
+    __disable_irq();
+    if (timers.has_deferred()) {
+        __enable_irq();
+        return;
+    }
+    const auto remaining = static_cast<int32_t>(deadline - HAL_GetTick());
+    const uint32_t ticks = timers.ticks_until_next(
+        remaining > 0 ? static_cast<uint32_t>(remaining) : 0
+    );
+    const bool stop_allowed = started && stop_guard != nullptr && stop_guard();
+
+    const IdleDecision decision = plan_idle(ticks, stop_allowed, policy);
+    if (decision.mode == IdleMode::Stop) {
+        stop(decision.ticks);
+    } else if (decision.mode == IdleMode::Sleep) {
+        const uint32_t start = DWT->CYCCNT;
+        __WFI();
+        ++counters.sleeps;
+        counters.sleep_cycles += DWT->CYCCNT - start;
+    }
+    __enable_irq();
+}
+
+TicklessClock::Stats TicklessClock::stats() {
+    const InterruptLock lock;
+    return counters;
+}
+
+}  // namespace obc
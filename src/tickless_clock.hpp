@@ -0,0 +1,116 @@
+/// Scheduler clock with tickless idle in stop mode.
+///
+/// 'TicklessClock' keeps time like 'SysTickClock', in HAL ticks of one
+/// millisecond, but waits for long deadlines in STOP1 or STOP2 instead of
+/// waking up on every SysTick. The wait is bounded by the next deadline and
+/// by the next tick needed by 'obc::timers', and planned by
+/// 'ccl::plan_idle'.
+///
+/// LPTIM1, clocked by the 32.768 kHz LSE crystal, counts freely through
+/// the stop and ends it with a compare match. SysTick is suspended while
+/// stopped. On wakeup the core runs on HSI16 or MSI until
+/// 'ClockManager::restore' restores the operating point and SysTick, or
+/// fails and leaves the core on the wakeup clock, which is counted. The
+/// HAL tick is then advanced by the time counted by LPTIM1 and the missed
+/// ticks of 'obc::timers' are caught up.
+/// 'ccl::TickCompensator' carries the fractions of a tick over, so the HAL
+/// tick does not drift from the LSE. Timers dispatched in interrupts are
+/// dispatched late by the wakeup time at most.
+///
+/// USART2, I2C1 and the DMA controllers are stopped in both modes. The stop
+/// guard must return false while any peripheral that needs the clocks is in
+/// use, the clock does not stop without a guard.
+///
+/// A UART passed to 'enable_uart_wakeup' keeps receiving while stopped and
+/// wakes the core up with its first byte, which the DMA then picks up. It
+/// runs on HSI16 for that, which it can only request in STOP1, so the clock
+/// stops in STOP1 instead of STOP2 from then on. The application enables it
+/// for USART2, so it always uses STOP1.
+///
+/// The wait also ends early while 'obc::timers' has deferred callbacks to
+/// run, see 'ccl::Task::ready'.
+///
+/// The wakeup latency is the time from the compare match until the clocks
+/// are restored, measured on LPTIM1 with a resolution of one LSE period,
+/// about 31 us.
+///
+/// # Examples
+///
+/// ```
+/// TicklessClock::init();
+/// TicklessClock::enable_uart_wakeup(&huart2).expect("No UART wakeup");
+/// TicklessClock::set_stop_guard([] { return uart_is_idle(); });
+/// TicklessClock::start().expect("Cannot start LPTIM1");
+///
+/// Scheduler<TicklessClock, std::size(tasks)> scheduler { tasks };
+/// scheduler.run();
+/// ```
+
+#ifndef OBC_TICKLESS_CLOCK_HPP
+#define OBC_TICKLESS_CLOCK_HPP
+
+#include <ccl/result.hpp>
+#include <cstdint>
+
+#include "hal_status.hpp"
+#include "stm32l4xx_hal.h"
+
+// See 'hal_status.hpp'.
+static_assert(
+    sizeof(ccl::Result<ccl::Unit, HAL_StatusTypeDef>)
+        == sizeof(HAL_StatusTypeDef),
+    "HAL_StatusTypeDef must use HAL_OK as its niche"
+);
+
+namespace obc {
+
+struct TicklessClock {
+    struct Stats {
+        uint32_t stops;
+        /// Time spent stopped, in STOP1 or STOP2.
+        uint32_t stop_ms;
+        /// Sleeps with SysTick running.
+        uint32_t sleeps;
+        uint64_t sleep_cycles;
+        uint32_t last_wakeup_us;
+        uint32_t max_wakeup_us;
+        /// Wakeups after which 'ClockManager::restore' failed.
+        uint32_t restore_failures;
+        HAL_StatusTypeDef last_restore_error;
+    };
+
+    /// Enables the DWT cycle counter. Until 'start' succeeds the clock
+    /// only sleeps until the next interrupt.
+    static void init();
+
+    /// Starts the LSE and LPTIM1. Waits for the LSE to stabilize, which may
+    /// take up to two seconds.
+    static ccl::Result<ccl::Unit, HAL_StatusTypeDef> start();
+
+    /// Sets the function telling whether the clock may stop. It is called
+    /// with interrupts masked.
+    static void set_stop_guard(bool (*guard)());
+
+    /// Lets 'huart' wake the core up when it receives a byte. Switches its
+    /// kernel clock to HSI16 and reinitializes it, so it must be called
+    /// before its reception and transmission are started.
+    static ccl::Result<ccl::Unit, HAL_StatusTypeDef> enable_uart_wakeup(
+        UART_HandleTypeDef* huart
+    );
+
+    static uint32_t now() {
+        return HAL_GetTick();
+    }
+
+    static uint32_t cycles() {
+        return DWT->CYCCNT;
+    }
+
+    static void idle_until(uint32_t deadline);
+
+    static Stats stats();
+};
+
+}  // namespace obc
+
+#endif
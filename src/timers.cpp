@@ -0,0 +1,16 @@
+#include "timers.hpp"
+
+#include "profiling.hpp"
+
+namespace obc {
+
+ccl::TimerWheel<InterruptLock> timers;
+ccl::ProfileStats timer_tick_profile { "timer_tick" };
+
+}  // namespace obc
+
+/// Called from 'SysTick_Handler' after 'HAL_IncTick'.
+extern "C" void obc_timer_tick() {
+    const obc::ProfileZone zone { obc::timer_tick_profile };
+    obc::timers.tick();
+}
@@ -0,0 +1,31 @@
+/// Software timers driven by SysTick.
+///
+/// 'timers' advances once per HAL tick, i.e. every millisecond, from
+/// 'SysTick_Handler'. Deferred timer callbacks run in the 'timers' task.
+///
+/// # Examples
+///
+/// ```
+/// ccl::Timer timeout { [] { abort_transfer(); } };
+///
+/// obc::timers.start(timeout, 100);
+/// ```
+
+#ifndef OBC_TIMERS_HPP
+#define OBC_TIMERS_HPP
+
+#include <ccl/profile.hpp>
+#include <ccl/timer_wheel.hpp>
+
+#include "interrupt_lock.hpp"
+
+namespace obc {
+
+extern ccl::TimerWheel<InterruptLock> timers;
+
+/// Time spent in 'timers.tick' per SysTick.
+extern ccl::ProfileStats timer_tick_profile;
+
+}  // namespace obc
+
+#endif
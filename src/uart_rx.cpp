@@ -0,0 +1,77 @@
+#include "uart_rx.hpp"
+
+#include "hal_callbacks.hpp"
+
+using namespace ccl::prelude;
+
+namespace obc {
+
+Result<ccl::Unit, HAL_StatusTypeDef> UartRx::start() {
+    if (hal::uart_rx_event.is_bound(huart_)) {
+        return Err { HAL_BUSY };
+    }
+
+    const bool bound =
+        hal::uart_rx_event
+            .try_bind(huart_, [this](uint16_t pos) { on_rx_event(pos); })
+            .is_ok()
+        && hal::uart_rx_error.try_bind(huart_, [this] { on_error(); }).is_ok();
+    const HAL_StatusTypeDef status = bound ? restart() : HAL_ERROR;
+    if (status != HAL_OK) {
+        hal::uart_rx_event.unbind(huart_);
+        hal::uart_rx_error.unbind(huart_);
+        return Err { status };
+    }
+    return Ok { ccl::Unit {} };
+}
+
+std::size_t UartRx::available() const {
+    return head_.load(std::memory_order_acquire) - tail_;
+}
+
+UartRx::Stats UartRx::stats() const {
+    return Stats {
+        head_.load(std::memory_order_relaxed)
+            - skipped_.load(std::memory_order_relaxed),
+        dropped_,
+        errors_.load(std::memory_order_relaxed),
+    };
+}
+
+void UartRx::on_rx_event(uint16_t pos) {
+    // 'pos' equals capacity on transfer complete, the DMA then continues
+    // from the start of the buffer.
+    const uint32_t delta =
+        pos >= last_pos_ ? pos - last_pos_ : capacity - last_pos_ + pos;
+    last_pos_ = pos & (capacity - 1);
+    head_.store(
+        head_.load(std::memory_order_relaxed) + delta,
+        std::memory_order_release
+    );
+}
+
+void UartRx::on_error() {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    // Overrun and DMA errors abort the reception, noise and framing errors
+    // do not.
+    if (huart_->RxState == HAL_UART_STATE_READY) {
+        restart();
+    }
+}
+
+HAL_StatusTypeDef UartRx::restart() {
+    // The DMA starts over at buffer offset 0, so move 'head_' to the next
+    // position with that offset. Same ordering as in 'on_rx_event'.
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t next = (head + capacity - 1) & ~uint32_t { capacity - 1 };
+    skipped_.store(
+        skipped_.load(std::memory_order_relaxed) + (next - head),
+        std::memory_order_relaxed
+    );
+    restart_head_.store(next, std::memory_order_relaxed);
+    head_.store(next, std::memory_order_release);
+    last_pos_ = 0;
+    return HAL_UARTEx_ReceiveToIdle_DMA(huart_, buffer_.data(), capacity);
+}
+
+}  // namespace obc
@@ -0,0 +1,161 @@
+/// Interrupt-driven UART receiver.
+///
+/// 'UartRx' runs the UART reception in circular DMA mode with idle-line
+/// detection. The DMA buffer itself is the ring buffer: the DMA controller
+/// is the producer and the application is the consumer. Interrupts are only
+/// raised on idle line, half transfer and transfer complete, never per byte.
+///
+/// The producer index is advanced from the HAL reception event callback,
+/// the consumer index from 'drain'. Each side writes only its own index, so
+/// no critical sections are needed.
+///
+/// The application has to call 'drain' at least once every 'capacity' byte
+/// times, otherwise the DMA overwrites unread data. Such data is discarded
+/// and accounted for in 'Stats::dropped'.
+///
+/// After an overrun or DMA error the reception restarts at the start of the
+/// buffer, so 'head_' skips ahead to the next multiple of 'capacity' and
+/// 'drain' discards the bytes it had not read before the restart. They are
+/// counted in 'Stats::dropped' as well, the stream has a hole there anyway.
+///
+/// # Examples
+///
+/// ```
+/// UartRx rx { &huart2 };
+/// rx.start().expect("Cannot start UART reception");
+///
+/// while (true) {
+///     rx.drain([](const uint8_t* data, std::size_t size) {
+///         parser.feed(data, size);
+///     });
+/// }
+/// ```
+
+#ifndef OBC_UART_RX_HPP
+#define OBC_UART_RX_HPP
+
+#include <array>
+#include <atomic>
+#include <ccl/result.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#include "hal_status.hpp"
+#include "stm32l4xx_hal.h"
+
+// See 'hal_status.hpp'.
+static_assert(
+    sizeof(ccl::Result<ccl::Unit, HAL_StatusTypeDef>)
+        == sizeof(HAL_StatusTypeDef),
+    "HAL_StatusTypeDef must use HAL_OK as its niche"
+);
+
+namespace obc {
+
+class UartRx {
+   public:
+    static constexpr std::size_t capacity = 512;
+
+    static_assert(
+        (capacity & (capacity - 1)) == 0,
+        "capacity must be a power of two"
+    );
+
+    struct Stats {
+        uint32_t received;
+        uint32_t dropped;
+        uint32_t errors;
+    };
+
+    explicit UartRx(UART_HandleTypeDef* huart) : huart_ { huart } {}
+
+    UartRx(const UartRx&) = delete;
+    UartRx(UartRx&&) = delete;
+    UartRx& operator=(const UartRx&) = delete;
+    UartRx& operator=(UartRx&&) = delete;
+    ~UartRx() = default;
+
+    /// Binds the HAL callbacks and starts the circular DMA reception. Only
+    /// one receiver per UART handle may be started.
+    ccl::Result<ccl::Unit, HAL_StatusTypeDef> start();
+
+    /// Number of bytes that can be drained without blocking.
+    std::size_t available() const;
+
+    /// Passes all received bytes to 'f' as at most two contiguous chunks
+    /// and returns the number of bytes consumed.
+    template <typename F>
+    std::size_t drain(F f) {
+        // A restart in between changes 'skipped_', read both again then.
+        uint32_t skipped;
+        uint32_t restart_head;
+        do {
+            skipped = skipped_.load(std::memory_order_acquire);
+            restart_head = restart_head_.load(std::memory_order_acquire);
+        } while (skipped_.load(std::memory_order_acquire) != skipped);
+        // 'restart_head_' is written before 'head_', so it is never ahead
+        // of the 'head' read after it.
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        if (static_cast<int32_t>(restart_head - tail_) > 0) {
+            // The skipped positions were never received.
+            dropped_ += restart_head - tail_ - (skipped - skipped_seen_);
+            tail_ = restart_head;
+        }
+        skipped_seen_ = skipped;
+        uint32_t size = head - tail_;
+        if (size > capacity) {
+            dropped_ += size;
+            tail_ = head;
+            return 0;
+        }
+
+        const std::size_t consumed = size;
+        while (size > 0) {
+            const std::size_t offset = tail_ & (capacity - 1);
+            const std::size_t chunk =
+                size < capacity - offset ? size : capacity - offset;
+            f(&buffer_[offset], chunk);
+            tail_ += chunk;
+            size -= chunk;
+        }
+        return consumed;
+    }
+
+    Stats stats() const;
+
+    /// Called from 'HAL_UARTEx_RxEventCallback' with the DMA write position.
+    void on_rx_event(uint16_t pos);
+
+    /// Called from 'HAL_UART_ErrorCallback'. Restarts the reception if the
+    /// HAL aborted it.
+    void on_error();
+
+    UART_HandleTypeDef* handle() const {
+        return huart_;
+    }
+
+   private:
+    HAL_StatusTypeDef restart();
+
+    UART_HandleTypeDef* huart_;
+    std::array<uint8_t, capacity> buffer_ {};
+
+    // Free running byte counters, the buffer offset is the counter modulo
+    // capacity. 'head_' is written only in interrupt context.
+    std::atomic<uint32_t> head_ { 0 };
+    uint32_t tail_ = 0;
+    uint32_t last_pos_ = 0;
+    // Value of 'head_' after the last restart, a multiple of capacity.
+    std::atomic<uint32_t> restart_head_ { 0 };
+    // Positions skipped by restarts, they were never received.
+    std::atomic<uint32_t> skipped_ { 0 };
+    // Value of 'skipped_' when 'drain' last caught up with a restart.
+    uint32_t skipped_seen_ = 0;
+
+    uint32_t dropped_ = 0;
+    std::atomic<uint32_t> errors_ { 0 };
+};
+
+}  // namespace obc
+
+#endif
@@ -0,0 +1,130 @@
+#include "uart_tx.hpp"
+
+#include <limits>
+
+#include "hal_callbacks.hpp"
+
+using namespace ccl::prelude;
+
+namespace obc {
+
+Result<ccl::Unit, HAL_StatusTypeDef> UartTx::start() {
+    if (hal::uart_tx_complete.is_bound(huart_)) {
+        return Err { HAL_BUSY };
+    }
+
+    const bool bound =
+        hal::uart_tx_complete.try_bind(huart_, [this] { on_tx_complete(); })
+            .is_ok()
+        && hal::uart_tx_error.try_bind(huart_, [this] { on_error(); }).is_ok();
+    if (!bound) {
+        hal::uart_tx_complete.unbind(huart_);
+        hal::uart_tx_error.unbind(huart_);
+        return Err { HAL_ERROR };
+    }
+    return Ok { ccl::Unit {} };
+}
+
+Result<uint32_t, HAL_StatusTypeDef> UartTx::send(
+    std::initializer_list<Segment> segments
+) {
+    uint32_t needed = 0;
+    uint32_t bytes = 0;
+    for (const Segment& segment : segments) {
+        if (segment.size > std::numeric_limits<uint16_t>::max()) {
+            return Err { HAL_ERROR };
+        }
+        if (segment.size > 0) {
+            ++needed;
+            bytes += segment.size;
+        }
+    }
+
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t tail = tail_.load(std::memory_order_acquire);
+    if (capacity - (head - tail) < needed) {
+        ++stalls_;
+        return Err { HAL_BUSY };
+    }
+
+    for (const Segment& segment : segments) {
+        if (segment.size > 0) {
+            queue_[head & (capacity - 1)] = segment;
+            ++head;
+        }
+    }
+
+    bytes_queued_ += bytes;
+    const uint32_t pending =
+        bytes_pending_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (pending > high_water_mark_) {
+        high_water_mark_ = pending;
+    }
+
+    head_.store(head, std::memory_order_release);
+    if (!busy_.exchange(true, std::memory_order_acq_rel)) {
+        start_next();
+    }
+    return Ok { head };
+}
+
+UartTx::Stats UartTx::stats() const {
+    return Stats {
+        bytes_queued_,
+        bytes_pending_.load(std::memory_order_relaxed),
+        high_water_mark_,
+        stalls_,
+        errors_.load(std::memory_order_relaxed),
+    };
+}
+
+void UartTx::on_tx_complete() {
+    pop();
+    start_next();
+}
+
+void UartTx::on_error() {
+    // A DMA error ends the transfer without a complete callback.
+    const bool aborted = (huart_->ErrorCode & HAL_UART_ERROR_DMA) != 0
+                         && huart_->gState == HAL_UART_STATE_READY;
+    if (aborted && busy_.load(std::memory_order_acquire)) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        pop();
+        start_next();
+    }
+}
+
+void UartTx::start_next() {
+    while (true) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            // 'send' either sees this store and starts the transfer itself
+            // or has already published its segments, which were seen above.
+            busy_.store(false, std::memory_order_release);
+            return;
+        }
+
+        const Segment& segment = queue_[tail & (capacity - 1)];
+        const HAL_StatusTypeDef status = HAL_UART_Transmit_DMA(
+            huart_,
+            const_cast<uint8_t*>(segment.data),
+            static_cast<uint16_t>(segment.size)
+        );
+        if (status == HAL_OK) {
+            return;
+        }
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        pop();
+    }
+}
+
+void UartTx::pop() {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    bytes_pending_.fetch_sub(
+        queue_[tail & (capacity - 1)].size,
+        std::memory_order_relaxed
+    );
+    tail_.store(tail + 1, std::memory_order_release);
+}
+
+}  // namespace obc
@@ -0,0 +1,141 @@
+/// Queued DMA UART transmitter.
+///
+/// 'UartTx' transmits a queue of caller-owned buffers back-to-back. Each
+/// call to 'send' enqueues a frame made of up to 'capacity' segments
+/// (e.g. header, payload and CRC) without copying them. The next segment
+/// is started directly from the transmit complete interrupt, so the caller
+/// never waits for the wire.
+///
+/// Buffers must stay valid and unchanged until 'is_sent' returns true for
+/// the ticket returned by 'send'.
+///
+/// The queue is a single-producer/single-consumer ring of segment
+/// descriptors: 'send' is the producer and may only be called from the main
+/// loop, the transmit complete interrupt is the consumer.
+///
+/// # Examples
+///
+/// ```
+/// UartTx tx { &huart2 };
+///
+/// uint32_t ticket = tx.send({ { header, 4 }, { payload, n }, { crc, 2 } })
+///                       .expect("Telemetry queue full");
+/// ...
+/// if (tx.is_sent(ticket)) { reuse(payload); }
+/// ```
+
+#ifndef OBC_UART_TX_HPP
+#define OBC_UART_TX_HPP
+
+#include <array>
+#include <atomic>
+#include <ccl/result.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "hal_status.hpp"
+#include "stm32l4xx_hal.h"
+
+// See 'hal_status.hpp'.
+static_assert(
+    sizeof(ccl::Result<ccl::Unit, HAL_StatusTypeDef>)
+        == sizeof(HAL_StatusTypeDef),
+    "HAL_StatusTypeDef must use HAL_OK as its niche"
+);
+
+namespace obc {
+
+class UartTx {
+   public:
+    static constexpr std::size_t capacity = 16;
+
+    static_assert(
+        (capacity & (capacity - 1)) == 0,
+        "capacity must be a power of two"
+    );
+
+    struct Segment {
+        const uint8_t* data;
+        std::size_t size;
+    };
+
+    struct Stats {
+        /// Total number of bytes accepted by 'send'.
+        uint32_t bytes_queued;
+        /// Bytes accepted but not yet transmitted.
+        uint32_t bytes_pending;
+        /// Maximum of 'bytes_pending' observed so far.
+        uint32_t high_water_mark;
+        /// Number of 'send' calls rejected because the queue was full.
+        uint32_t stalls;
+        uint32_t errors;
+    };
+
+    explicit UartTx(UART_HandleTypeDef* huart) : huart_ { huart } {}
+
+    UartTx(const UartTx&) = delete;
+    UartTx(UartTx&&) = delete;
+    UartTx& operator=(const UartTx&) = delete;
+    UartTx& operator=(UartTx&&) = delete;
+    ~UartTx() = default;
+
+    /// Binds the HAL callbacks of its UART handle. Only one transmitter per
+    /// UART handle may be started.
+    ccl::Result<ccl::Unit, HAL_StatusTypeDef> start();
+
+    /// Enqueues all segments as one frame. Fails with 'HAL_BUSY' if there
+    /// is not enough room for the whole frame and with 'HAL_ERROR' if
+    /// a segment does not fit in a single DMA transfer.
+    ///
+    /// On success returns a ticket for 'is_sent'.
+    ccl::Result<uint32_t, HAL_StatusTypeDef> send(
+        std::initializer_list<Segment> segments
+    );
+
+    /// Checks whether the frame identified by 'ticket' left the UART.
+    bool is_sent(uint32_t ticket) const {
+        const uint32_t done = tail_.load(std::memory_order_acquire);
+        return static_cast<int32_t>(done - ticket) >= 0;
+    }
+
+    bool is_idle() const {
+        return !busy_.load(std::memory_order_acquire);
+    }
+
+    Stats stats() const;
+
+    /// Called from 'HAL_UART_TxCpltCallback'.
+    void on_tx_complete();
+
+    /// Called from 'HAL_UART_ErrorCallback'. Skips the current segment if
+    /// the HAL aborted its transfer.
+    void on_error();
+
+    UART_HandleTypeDef* handle() const {
+        return huart_;
+    }
+
+   private:
+    void start_next();
+    void pop();
+
+    UART_HandleTypeDef* huart_;
+    std::array<Segment, capacity> queue_ {};
+
+    // Free running segment counters, the queue index is the counter modulo
+    // capacity. 'head_' is written by 'send', 'tail_' by the interrupt.
+    std::atomic<uint32_t> head_ { 0 };
+    std::atomic<uint32_t> tail_ { 0 };
+    std::atomic<bool> busy_ { false };
+
+    uint32_t bytes_queued_ = 0;
+    std::atomic<uint32_t> bytes_pending_ { 0 };
+    uint32_t high_water_mark_ = 0;
+    uint32_t stalls_ = 0;
+    std::atomic<uint32_t> errors_ { 0 };
+};
+
+}  // namespace obc
+
+#endif
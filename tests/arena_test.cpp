@@ -0,0 +1,104 @@
+#include <array>
+#include <ccl/arena.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::Arena;
+
+namespace {
+
+struct Sample {
+    uint32_t time;
+    float value;
+};
+
+void test_allocation() {
+    alignas(std::max_align_t) static unsigned char buffer[256];
+    Arena arena { buffer, sizeof(buffer) };
+
+    auto* byte = static_cast<unsigned char*>(arena.try_allocate(1, 1).unwrap());
+    CHECK(byte == buffer);
+    const auto sample = arena.try_make<Sample>(Sample { 5, 1.5F }).unwrap();
+    CHECK(reinterpret_cast<std::uintptr_t>(sample.get()) % alignof(Sample)
+          == 0);
+    CHECK(sample->time == 5);
+
+    uint16_t* values = arena.try_make_array<uint16_t>(10).unwrap();
+    bool zeroed = true;
+    for (int i = 0; i < 10; ++i) {
+        zeroed &= values[i] == 0;
+    }
+    CHECK(zeroed);
+
+    void* aligned = arena.try_allocate(8, 64).unwrap();
+    CHECK(reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0);
+
+    CHECK(arena.try_allocate(1024).is_err());
+    CHECK(arena.try_make_array<uint64_t>(SIZE_MAX / 4).is_err());
+}
+
+void test_rewind() {
+    alignas(std::max_align_t) static unsigned char buffer[128];
+    Arena arena { buffer, sizeof(buffer) };
+
+    CHECK(arena.try_allocate(16).is_ok());
+    const std::size_t before = arena.used();
+    {
+        const Arena::Scope scope { arena };
+        CHECK(arena.try_allocate(64).is_ok());
+        CHECK(arena.used() > before);
+    }
+    CHECK(arena.used() == before);
+    CHECK(arena.high_water() >= before + 64);
+
+    // The space released by the scope can be used again in full.
+    CHECK(arena.try_allocate(sizeof(buffer) - before).is_ok());
+    CHECK(arena.try_allocate(1, 1).is_err());
+    arena.reset();
+    CHECK(arena.used() == 0);
+    CHECK(arena.high_water() == sizeof(buffer));
+}
+
+// Cost per object of building a batch of 16 samples and dropping them
+// together, as a scoped rewind and with malloc and free. The host malloc
+// is not newlib's, only the order of magnitude carries over.
+void bench_against_malloc() {
+    alignas(std::max_align_t) static unsigned char buffer[1024];
+    Arena arena { buffer, sizeof(buffer) };
+    constexpr uint32_t batch = 16;
+
+    const double arena_cost = test::measure(100'000, [&arena] {
+        const Arena::Scope scope { arena };
+        for (uint32_t i = 0; i < batch; ++i) {
+            test::keep(arena.try_make<Sample>(Sample { i, 0.0F }).unwrap());
+        }
+    });
+
+    std::array<Sample*, batch> samples {};
+    const double malloc_cost = test::measure(100'000, [&samples] {
+        for (uint32_t i = 0; i < batch; ++i) {
+            samples[i] = static_cast<Sample*>(std::malloc(sizeof(Sample)));
+            *samples[i] = Sample { i, 0.0F };
+            test::keep(samples[i]);
+        }
+        for (Sample* sample : samples) {
+            std::free(sample);
+        }
+    });
+
+    test::report("Arena try_make + rewind", arena_cost / batch);
+    test::report("malloc + free", malloc_cost / batch);
+}
+
+}  // namespace
+
+int main() {
+    test_allocation();
+    test_rewind();
+    bench_against_malloc();
+    return test::exit_code();
+}
@@ -0,0 +1,115 @@
+/// Timing for the host benchmarks.
+///
+/// 'measure' runs a loop of 'iterations' calls several times and returns
+/// the cost of one call in the fastest run, so other load on the host
+/// matters little. Costs are in 'BenchClock' units: TSC cycles on x86,
+/// nanoseconds elsewhere. Benchmarks print their results with 'report' to
+/// compare implementations, they do not fail the test.
+///
+/// 'Samples' collects the durations of single calls for their worst case.
+/// The longest calls on the host include preemptions by other processes,
+/// so the 99.9th percentile is reported next to the maximum.
+///
+/// 'keep' makes the optimizer assume a value is used, so the work that
+/// produced it is not removed.
+///
+/// # Examples
+///
+/// ```
+/// const double cost = test::measure(100'000, [&] {
+///     test::keep(reader.read<uint32_t>());
+/// });
+/// test::report("read<uint32_t>", cost);
+/// ```
+
+#ifndef OBC_TESTS_BENCH_HPP
+#define OBC_TESTS_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace test {
+
+struct BenchClock {
+#if defined(__x86_64__) || defined(__i386__)
+    static constexpr const char* unit = "TSC cycles";
+
+    static uint64_t now() {
+        return __rdtsc();
+    }
+#else
+    static constexpr const char* unit = "ns";
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+#endif
+};
+
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+template <typename Body>
+double measure(uint32_t iterations, Body body, int runs = 10) {
+    uint64_t best = UINT64_MAX;
+    for (int run = 0; run < runs; ++run) {
+        const uint64_t start = BenchClock::now();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        best = std::min(best, BenchClock::now() - start);
+    }
+    return static_cast<double>(best) / iterations;
+}
+
+inline void report(const char* name, double cost) {
+    std::printf("%-32s %8.1f %s\n", name, cost, BenchClock::unit);
+}
+
+class Samples {
+   public:
+    /// Adds the time since 'start', a value of 'BenchClock::now'.
+    void add(uint64_t start) {
+        durations_.push_back(BenchClock::now() - start);
+    }
+
+    void report(const char* name) {
+        if (durations_.empty()) {
+            return;
+        }
+        std::sort(durations_.begin(), durations_.end());
+        uint64_t total = 0;
+        for (const uint64_t duration : durations_) {
+            total += duration;
+        }
+        std::printf(
+            "%-32s mean %.1f, 99.9%% %llu, max %llu %s\n",
+            name,
+            static_cast<double>(total) / durations_.size(),
+            static_cast<unsigned long long>(
+                durations_[durations_.size() * 999 / 1000]
+            ),
+            static_cast<unsigned long long>(durations_.back()),
+            BenchClock::unit
+        );
+    }
+
+   private:
+    std::vector<uint64_t> durations_;
+};
+
+}  // namespace test
+
+#endif
@@ -0,0 +1,156 @@
+#include <array>
+#include <ccl/byte_io.hpp>
+#include <ccl/span.hpp>
+#include <cstdint>
+#include <cstring>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::ByteReader;
+using ccl::ByteWriter;
+using ccl::Endian;
+using ccl::Span;
+
+namespace {
+
+enum class Command : uint16_t { Reset = 0x0102 };
+
+void test_round_trip() {
+    std::array<uint8_t, 19> buffer {};
+    ByteWriter writer { buffer };
+    CHECK(writer.write<uint8_t>(0xAA).is_ok());
+    // Unaligned from here on.
+    CHECK((writer.write<uint32_t, Endian::Big>(0x11223344).is_ok()));
+    CHECK(writer.write<uint32_t>(0x11223344).is_ok());
+    CHECK(writer.write<Command>(Command::Reset).is_ok());
+    CHECK(writer.write<float>(1.5F).is_ok());
+    CHECK(writer.write<int32_t>(-2).is_ok());
+    CHECK(writer.remaining() == 0);
+    CHECK(writer.write<uint8_t>(0).is_err());
+    CHECK(writer.written().size() == buffer.size());
+
+    CHECK(buffer[1] == 0x11 && buffer[4] == 0x44);
+    CHECK(buffer[5] == 0x44 && buffer[8] == 0x11);
+    CHECK(buffer[9] == 0x02 && buffer[10] == 0x01);
+
+    ByteReader reader { buffer };
+    CHECK(reader.read<uint8_t>().unwrap() == 0xAA);
+    CHECK((reader.read<uint32_t, Endian::Big>().unwrap() == 0x11223344));
+    CHECK(reader.read<uint32_t>().unwrap() == 0x11223344);
+    CHECK(reader.read<Command>().unwrap() == Command::Reset);
+    CHECK(reader.read<float>().unwrap() == 1.5F);
+    CHECK(reader.read<int32_t>().unwrap() == -2);
+    CHECK(reader.read<uint8_t>().is_err());
+    CHECK((reader.read_at<uint16_t, Endian::Big>(9).unwrap() == 0x0201));
+}
+
+void test_bounds() {
+    std::array<uint8_t, 4> buffer { 1, 2, 3, 4 };
+    ByteReader reader { buffer };
+    CHECK(reader.read_at<uint32_t>(1).is_err());
+    CHECK(reader.skip(3).is_ok());
+    // A failed read does not advance.
+    CHECK(reader.read<uint16_t>().is_err());
+    CHECK(reader.position() == 3);
+    CHECK(reader.read_bytes(1).unwrap()[0] == 4);
+
+    ByteWriter writer { buffer };
+    CHECK(writer.write_at<uint16_t>(3, 0).is_err());
+    CHECK(buffer[3] == 4);
+    const uint8_t bytes[] = { 9, 9, 9, 9, 9 };
+    CHECK(writer.write_bytes(bytes).is_err());
+    CHECK(writer.position() == 0);
+
+    const Span<uint8_t> span { buffer };
+    CHECK(span.subspan(1, 2).size() == 2);
+    CHECK(span.last(1)[0] == 4);
+    CHECK(span.first(0).empty());
+}
+
+struct Record {
+    uint8_t id;
+    uint32_t time;
+    float value;
+    uint16_t flags;
+};
+
+constexpr std::size_t record_size = 11;
+
+// The hand-written encoding the readers and writers replace, with the same
+// bounds check per record.
+bool encode_memcpy(uint8_t* buffer, std::size_t size, const Record& record) {
+    if (size < record_size) {
+        return false;
+    }
+    const uint32_t time = __builtin_bswap32(record.time);
+    buffer[0] = record.id;
+    std::memcpy(buffer + 1, &time, sizeof(time));
+    std::memcpy(buffer + 5, &record.value, sizeof(record.value));
+    std::memcpy(buffer + 9, &record.flags, sizeof(record.flags));
+    return true;
+}
+
+bool decode_memcpy(const uint8_t* buffer, std::size_t size, Record& record) {
+    if (size < record_size) {
+        return false;
+    }
+    uint32_t time = 0;
+    record.id = buffer[0];
+    std::memcpy(&time, buffer + 1, sizeof(time));
+    record.time = __builtin_bswap32(time);
+    std::memcpy(&record.value, buffer + 5, sizeof(record.value));
+    std::memcpy(&record.flags, buffer + 9, sizeof(record.flags));
+    return true;
+}
+
+// Cost of encoding and decoding one record, against memcpy.
+void bench_record() {
+    std::array<uint8_t, record_size> buffer {};
+    Record record { 7, 0x01020304, 2.5F, 0x0102 };
+
+    const double writer_cost = test::measure(1'000'000, [&] {
+        test::keep(buffer);
+        ByteWriter writer { buffer };
+        const bool ok = writer.write<uint8_t>(record.id).is_ok()
+                     && writer.write<uint32_t, Endian::Big>(record.time)
+                            .is_ok()
+                     && writer.write<float>(record.value).is_ok()
+                     && writer.write<uint16_t>(record.flags).is_ok();
+        test::keep(ok);
+    });
+    const double encode_cost = test::measure(1'000'000, [&] {
+        test::keep(buffer);
+        test::keep(encode_memcpy(buffer.data(), buffer.size(), record));
+    });
+
+    const double reader_cost = test::measure(1'000'000, [&] {
+        test::keep(buffer);
+        ByteReader reader { buffer };
+        record.id = reader.read<uint8_t>().unwrap();
+        record.time = reader.read<uint32_t, Endian::Big>().unwrap();
+        record.value = reader.read<float>().unwrap();
+        record.flags = reader.read<uint16_t>().unwrap();
+        test::keep(record);
+    });
+    const double decode_cost = test::measure(1'000'000, [&] {
+        test::keep(buffer);
+        test::keep(decode_memcpy(buffer.data(), buffer.size(), record));
+        test::keep(record);
+    });
+    CHECK(record.time == 0x01020304 && record.flags == 0x0102);
+
+    test::report("ByteWriter record", writer_cost);
+    test::report("memcpy encode record", encode_cost);
+    test::report("ByteReader record", reader_cost);
+    test::report("memcpy decode record", decode_cost);
+}
+
+}  // namespace
+
+int main() {
+    test_round_trip();
+    test_bounds();
+    bench_record();
+    return test::exit_code();
+}
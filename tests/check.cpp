@@ -0,0 +1,37 @@
+#include "check.hpp"
+
+#include <atomic>
+#include <ccl/panic.hpp>
+#include <cstdio>
+
+namespace test {
+
+namespace {
+
+std::atomic<unsigned> failures = 0;
+
+}  // namespace
+
+void fail(const char* condition, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+    failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+int exit_code() {
+    const unsigned count = failures.load(std::memory_order_relaxed);
+    if (count != 0) {
+        std::fprintf(stderr, "%u checks failed\n", count);
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace test
+
+namespace ccl {
+
+void panic_hook(std::string_view msg, SourceLocation /*loc*/) {
+    throw test::Panic { std::string { msg } };
+}
+
+}  // namespace ccl
@@ -0,0 +1,67 @@
+/// Minimal assertions for the host tests.
+///
+/// 'CHECK(condition)' reports a failed condition with its location and lets
+/// the test continue, so one run shows all failures. 'CHECK_PANICS(expr)'
+/// checks that evaluating 'expr' calls 'ccl::panic': on the host
+/// 'panic_hook' throws 'test::Panic' instead of halting. A test's 'main'
+/// returns 'test::exit_code()'.
+///
+/// Checks may be used from several threads.
+///
+/// # Examples
+///
+/// ```
+/// int main() {
+///     const Result<int, int> result = Ok { 1 };
+///     CHECK(result.is_ok());
+///     CHECK(result.unwrap() == 1);
+///     CHECK_PANICS(result.unwrap_err());
+///     return test::exit_code();
+/// }
+/// ```
+
+#ifndef OBC_TESTS_CHECK_HPP
+#define OBC_TESTS_CHECK_HPP
+
+#include <string>
+
+namespace test {
+
+/// 'Lock' of the ccl types for tests without concurrency. The constructor
+/// keeps the unused lock variables from being warned about.
+struct NoLock {
+    NoLock() {}  // NOLINT(modernize-use-equals-default)
+};
+
+/// Thrown by 'ccl::panic_hook'.
+struct Panic {
+    std::string message;
+};
+
+void fail(const char* condition, const char* file, int line);
+
+/// 0 if no check failed, 1 otherwise.
+int exit_code();
+
+}  // namespace test
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CHECK(condition)                                \
+    ((condition) ? static_cast<void>(0)                 \
+                 : ::test::fail(#condition, __FILE__, __LINE__))
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CHECK_PANICS(expr)                                         \
+    do {                                                           \
+        bool check_panicked_ = false;                              \
+        try {                                                      \
+            static_cast<void>(expr);                               \
+        } catch (const ::test::Panic&) {                           \
+            check_panicked_ = true;                                \
+        }                                                          \
+        if (!check_panicked_) {                                    \
+            ::test::fail("panics: " #expr, __FILE__, __LINE__);    \
+        }                                                          \
+    } while (false)
+
+#endif
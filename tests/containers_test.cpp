@@ -0,0 +1,227 @@
+#include <ccl/static_deque.hpp>
+#include <ccl/static_string.hpp>
+#include <ccl/static_vector.hpp>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using namespace ccl::prelude;
+using ccl::StaticDeque;
+using ccl::StaticString;
+using ccl::StaticVector;
+
+namespace {
+
+// Counts live objects to catch missing or double destruction.
+struct Tracked {
+    static inline int live = 0;
+
+    explicit Tracked(int v) : value { v } {
+        ++live;
+    }
+
+    Tracked(const Tracked& other) : value { other.value } {
+        ++live;
+    }
+
+    Tracked(Tracked&& other) noexcept : value { other.value } {
+        other.value = -1;
+        ++live;
+    }
+
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+
+    ~Tracked() {
+        --live;
+    }
+
+    int value;
+};
+
+static_assert(std::is_trivially_copyable_v<StaticVector<int, 4>>);
+static_assert(std::is_trivially_copyable_v<StaticDeque<int, 4>>);
+static_assert(std::is_trivially_copyable_v<StaticString<8>>);
+static_assert(sizeof(StaticVector<uint8_t, 8>) == 9);
+
+constexpr int constexpr_sum() {
+    StaticVector<int, 4> vector { 1, 2, 3 };
+    int sum = 0;
+    for (const int v : vector) {
+        sum += v;
+    }
+    StaticDeque<int, 3> deque;
+    (void)deque.try_push_back(4);
+    (void)deque.try_push_front(5);
+    return sum + deque.front() * 10 + deque.back();
+}
+
+static_assert(constexpr_sum() == 60);
+
+void test_vector() {
+    {
+        StaticVector<Tracked, 3> vector;
+        CHECK(vector.try_emplace(1).is_ok());
+        CHECK(vector.try_push(Tracked { 2 }).is_ok());
+        CHECK(vector.try_emplace(3).is_ok());
+        CHECK(vector.full());
+        CHECK(vector.try_emplace(4).is_err());
+        CHECK(Tracked::live == 3);
+
+        vector.erase(vector.begin());
+        CHECK(vector.size() == 2);
+        CHECK(vector[0].value == 2 && vector[1].value == 3);
+        CHECK(Tracked::live == 2);
+
+        StaticVector<Tracked, 3> copy = vector;
+        CHECK(Tracked::live == 4);
+        const StaticVector<Tracked, 3> moved = std::move(copy);
+        CHECK(moved.size() == 2 && moved.back().value == 3);
+
+        const std::optional<Tracked> last = vector.pop();
+        CHECK(last.has_value() && last->value == 3);
+        CHECK(vector.size() == 1);
+    }
+    CHECK(Tracked::live == 0);
+}
+
+void test_deque() {
+    {
+        // Interleaved operations against std::deque, wrapping many times.
+        StaticDeque<Tracked, 5> deque;
+        std::deque<int> reference;
+        unsigned state = 1;
+        for (int i = 0; i < 10000; ++i) {
+            state = state * 1103515245 + 12345;
+            switch ((state >> 16) % 4) {
+                case 0:
+                    CHECK(
+                        deque.try_push_back(Tracked { i }).is_ok()
+                        == (reference.size() < 5)
+                    );
+                    if (reference.size() < 5) {
+                        reference.push_back(i);
+                    }
+                    break;
+                case 1:
+                    CHECK(
+                        deque.try_emplace_front(i).is_ok()
+                        == (reference.size() < 5)
+                    );
+                    if (reference.size() < 5) {
+                        reference.push_front(i);
+                    }
+                    break;
+                case 2: {
+                    const std::optional<Tracked> value = deque.pop_front();
+                    CHECK(value.has_value() == !reference.empty());
+                    if (value) {
+                        CHECK(value->value == reference.front());
+                        reference.pop_front();
+                    }
+                    break;
+                }
+                default: {
+                    const std::optional<Tracked> value = deque.pop_back();
+                    CHECK(value.has_value() == !reference.empty());
+                    if (value) {
+                        CHECK(value->value == reference.back());
+                        reference.pop_back();
+                    }
+                    break;
+                }
+            }
+            CHECK(deque.size() == reference.size());
+            CHECK(Tracked::live == static_cast<int>(reference.size()));
+        }
+
+        const StaticDeque<Tracked, 5>& source = deque;
+        StaticDeque<Tracked, 5> copy = source;
+        CHECK(copy.size() == deque.size());
+        for (std::size_t i = 0; i < copy.size(); ++i) {
+            CHECK(copy[i].value == deque[i].value);
+        }
+    }
+    CHECK(Tracked::live == 0);
+}
+
+void test_string() {
+    StaticString<8> name = "obc";
+    CHECK(name.try_append("-hal").is_ok());
+    CHECK(name.view() == "obc-hal");
+    CHECK(name.try_append("ab").is_err());
+    CHECK(name.view() == "obc-hal");
+    CHECK(name.try_push('!').is_ok());
+    CHECK(name.full());
+    CHECK(std::string { name.c_str() } == "obc-hal!");
+    name.truncate(3);
+    CHECK(name == StaticString<8> { "obc" });
+    CHECK(name.c_str()[3] == '\0');
+}
+
+// Cost per element of filling and emptying 32 elements, against the std
+// containers with their storage already allocated.
+void bench_against_std() {
+    constexpr uint32_t count = 32;
+
+    StaticVector<uint32_t, count> vector;
+    const double vector_cost = test::measure(100'000, [&vector] {
+        for (uint32_t i = 0; i < count; ++i) {
+            static_cast<void>(vector.try_push(i));
+        }
+        test::keep(vector);
+        vector.clear();
+    });
+    std::vector<uint32_t> std_vector;
+    std_vector.reserve(count);
+    const double std_vector_cost = test::measure(100'000, [&std_vector] {
+        for (uint32_t i = 0; i < count; ++i) {
+            std_vector.push_back(i);
+        }
+        test::keep(std_vector.data()[count - 1]);
+        std_vector.clear();
+    });
+
+    StaticDeque<uint32_t, count> deque;
+    uint32_t sum = 0;
+    const double deque_cost = test::measure(100'000, [&deque, &sum] {
+        for (uint32_t i = 0; i < count; ++i) {
+            static_cast<void>(deque.try_push_back(i));
+        }
+        while (const auto value = deque.pop_front()) {
+            sum += *value;
+        }
+    });
+    std::deque<uint32_t> std_deque(count);
+    std_deque.clear();
+    const double std_deque_cost = test::measure(100'000, [&std_deque, &sum] {
+        for (uint32_t i = 0; i < count; ++i) {
+            std_deque.push_back(i);
+        }
+        while (!std_deque.empty()) {
+            sum += std_deque.front();
+            std_deque.pop_front();
+        }
+    });
+    test::keep(sum);
+
+    test::report("StaticVector try_push + clear", vector_cost / count);
+    test::report("std::vector push_back + clear", std_vector_cost / count);
+    test::report("StaticDeque push + pop", deque_cost / count);
+    test::report("std::deque push + pop", std_deque_cost / count);
+}
+
+}  // namespace
+
+int main() {
+    test_vector();
+    test_deque();
+    test_string();
+    bench_against_std();
+    return test::exit_code();
+}
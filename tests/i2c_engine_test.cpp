@@ -0,0 +1,186 @@
+#include <array>
+#include <ccl/i2c_engine.hpp>
+#include <cstdint>
+#include <map>
+
+#include "check.hpp"
+
+using ccl::I2cBatch;
+using ccl::I2cEngine;
+using ccl::I2cTransfer;
+using ccl::InplaceFunction;
+
+namespace {
+
+struct SimClock {
+    static inline uint32_t now = 0;
+
+    static uint32_t cycles() {
+        return now;
+    }
+};
+
+// Simulated bus with register mapped devices. A transfer takes 100 cycles
+// per byte and completes when 'step' is called, like an interrupt the
+// test raises. Transfers to unknown addresses are not acknowledged.
+class SimBus {
+   public:
+    static constexpr uint32_t cycles_per_byte = 100;
+
+    void bind(InplaceFunction<void(bool)> done) {
+        done_ = done;
+    }
+
+    bool begin(const I2cTransfer& transfer) {
+        if (busy_ || transfer.address == refused_address) {
+            return false;
+        }
+        busy_ = true;
+        current_ = &transfer;
+        if (synchronous) {
+            step();
+        }
+        return true;
+    }
+
+    /// Completes the transfer in progress. Returns false if there is none.
+    bool step() {
+        if (!busy_) {
+            return false;
+        }
+        const I2cTransfer& transfer = *current_;
+        SimClock::now += cycles_per_byte * (transfer.data.size() + 2);
+        const auto device = devices.find(transfer.address);
+        const bool ack = device != devices.end();
+        if (ack) {
+            for (std::size_t i = 0; i < transfer.data.size(); ++i) {
+                uint8_t& reg = device->second[(transfer.reg + i) & 0xFF];
+                if (transfer.direction == I2cTransfer::Direction::Read) {
+                    transfer.data[i] = reg;
+                } else {
+                    reg = transfer.data[i];
+                }
+            }
+        }
+        busy_ = false;
+        done_(ack);
+        return true;
+    }
+
+    /// Reports a completion without a transfer, e.g. a late error.
+    void raise_spurious() {
+        done_(false);
+    }
+
+    static constexpr uint8_t refused_address = 0x7F;
+
+    std::map<uint8_t, std::array<uint8_t, 256>> devices;
+    bool synchronous = false;
+
+   private:
+    InplaceFunction<void(bool)> done_;
+    const I2cTransfer* current_ = nullptr;
+    bool busy_ = false;
+};
+
+using Engine = I2cEngine<SimBus, SimClock, test::NoLock>;
+
+void run_bus(SimBus& bus) {
+    while (bus.step()) {}
+}
+
+void test_batches() {
+    SimBus bus;
+    bus.devices[0x6A][0x0F] = 0x6A;
+    bus.devices[0x48][0x01] = 0x60;
+    Engine engine { bus };
+
+    std::array<uint8_t, 1> id {};
+    std::array<uint8_t, 2> missing {};
+    std::array<uint8_t, 1> config {};
+    std::array<uint8_t, 2> threshold { 0x12, 0x34 };
+    I2cTransfer sensors[] = {
+        I2cTransfer::read(0x6A, 0x0F, id),
+        I2cTransfer::read(0x50, 0x00, missing),
+        I2cTransfer::read(0x48, 0x01, config),
+    };
+    I2cTransfer writes[] = {
+        I2cTransfer::write(0x48, 0x02, threshold),
+        I2cTransfer::read(SimBus::refused_address, 0x00, config),
+    };
+
+    int order = 0;
+    I2cBatch first { sensors, [&](I2cBatch&) { order = order * 10 + 1; } };
+    I2cBatch second { writes, [&](I2cBatch&) { order = order * 10 + 2; } };
+    engine.submit(first);
+    engine.submit(second);
+    CHECK(first.is_pending() && second.is_pending());
+    CHECK(!engine.is_idle());
+    run_bus(bus);
+
+    CHECK(order == 12);
+    CHECK(engine.is_idle());
+    CHECK(!first.is_pending() && !second.is_pending());
+    CHECK(id[0] == 0x6A);
+    CHECK(config[0] == 0x60);
+    CHECK(sensors[0].status == I2cTransfer::Status::Ok);
+    CHECK(sensors[1].status == I2cTransfer::Status::Error);
+    CHECK(sensors[2].status == I2cTransfer::Status::Ok);
+    CHECK(!first.succeeded());
+    CHECK(bus.devices[0x48][0x02] == 0x12 && bus.devices[0x48][0x03] == 0x34);
+    CHECK(writes[1].status == I2cTransfer::Status::Error);
+    CHECK(writes[1].cycles == 0);
+    CHECK(sensors[0].cycles == 3 * SimBus::cycles_per_byte);
+
+    const ccl::I2cStats stats = engine.stats();
+    CHECK(stats.transfers == 5);
+    CHECK(stats.errors == 2);
+    CHECK(stats.batches == 2);
+    // 3 + 4 + 3 + 4 bytes, the refused transfer never started.
+    CHECK(stats.busy_cycles == 14 * SimBus::cycles_per_byte);
+    CHECK(stats.window_cycles == stats.busy_cycles);
+    CHECK(second.latency_cycles() == stats.window_cycles);
+    CHECK(stats.max_batch_latency_cycles == second.latency_cycles());
+    CHECK(stats.spurious == 0);
+}
+
+void test_resubmit_and_spurious() {
+    SimBus bus;
+    bus.devices[0x48][0x00] = 0x19;
+    bus.synchronous = true;
+    Engine engine { bus };
+
+    // Completes inside 'begin' and resubmits itself from its callback.
+    std::array<uint8_t, 1> temperature {};
+    I2cTransfer transfers[] = { I2cTransfer::read(0x48, 0x00, temperature) };
+    int runs = 0;
+    I2cBatch batch { transfers, [&](I2cBatch& done) {
+                        if (++runs < 5) {
+                            engine.submit(done);
+                        }
+                    } };
+    engine.submit(batch);
+    CHECK(runs == 5);
+    CHECK(batch.succeeded());
+    CHECK(engine.is_idle());
+
+    bus.synchronous = false;
+    engine.submit(batch);
+    CHECK_PANICS(engine.submit(batch));
+    run_bus(bus);
+    CHECK(runs == 6);
+
+    engine.reset_stats();
+    bus.raise_spurious();
+    CHECK(engine.stats().spurious == 1);
+    CHECK(engine.stats().transfers == 0);
+    CHECK(engine.is_idle());
+}
+
+}  // namespace
+
+int main() {
+    test_batches();
+    test_resubmit_and_spurious();
+    return test::exit_code();
+}
@@ -0,0 +1,118 @@
+#include <ccl/callback_table.hpp>
+#include <ccl/inplace_function.hpp>
+#include <cstdint>
+#include <type_traits>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::CallbackTable;
+using ccl::InplaceFunction;
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<InplaceFunction<void()>>);
+static_assert(sizeof(InplaceFunction<void()>) <= 4 * sizeof(void*));
+
+int twice(int value) {
+    return value * 2;
+}
+
+struct Handle {
+    int id;
+};
+
+void test_function() {
+    const InplaceFunction<int(int)> empty;
+    CHECK(!empty);
+    CHECK_PANICS(empty(1));
+
+    const InplaceFunction<int(int)> pointer = twice;
+    CHECK(pointer && pointer(4) == 8);
+
+    int calls = 0;
+    const int offset = 3;
+    InplaceFunction<int(int)> lambda = [&calls, offset](int value) {
+        ++calls;
+        return value + offset;
+    };
+    const InplaceFunction<int(int)> copy = lambda;
+    CHECK(lambda(1) == 4);
+    CHECK(copy(2) == 5);
+    CHECK(calls == 2);
+}
+
+void test_table() {
+    Handle uart1 { 1 };
+    Handle uart2 { 2 };
+    CallbackTable<Handle, void(uint16_t), 3> table;
+
+    uint32_t rx = 0;
+    uint32_t tx = 0;
+    uint32_t other = 0;
+    CHECK(table.try_bind(&uart1, [&rx](uint16_t size) { rx += size; })
+              .is_ok());
+    CHECK(table.try_bind(&uart1, [&tx](uint16_t size) { tx += size; })
+              .is_ok());
+    CHECK(table.try_bind(&uart2, [&other](uint16_t) { ++other; }).is_ok());
+    CHECK(table.try_bind(&uart2, [](uint16_t) {}).is_err());
+
+    CHECK(table.dispatch(&uart1, 5));
+    CHECK(rx == 5 && tx == 5 && other == 0);
+
+    table.unbind(&uart1);
+    CHECK(!table.is_bound(&uart1));
+    CHECK(!table.dispatch(&uart1, 5));
+    CHECK(table.dispatch(&uart2, 5));
+    CHECK(other == 1);
+}
+
+// Cost of an indirect call. 'keep' forces every call to load the target
+// again, as a call through a callback stored elsewhere does.
+void bench_call() {
+    int (*raw)(int) = twice;
+    int value = 0;
+    const double raw_cost = test::measure(1'000'000, [&] {
+        test::keep(raw);
+        value = raw(value);
+    });
+
+    InplaceFunction<int(int)> pointer = twice;
+    const double pointer_cost = test::measure(1'000'000, [&] {
+        test::keep(pointer);
+        value = pointer(value);
+    });
+
+    int calls = 0;
+    InplaceFunction<int(int)> lambda = [&calls](int argument) {
+        ++calls;
+        return argument + 1;
+    };
+    const double lambda_cost = test::measure(1'000'000, [&] {
+        test::keep(lambda);
+        value = lambda(value);
+    });
+
+    Handle uart { 1 };
+    CallbackTable<Handle, void(uint16_t), 4> table;
+    table.try_bind(&uart, [&calls](uint16_t) { ++calls; }).unwrap();
+    const double dispatch_cost = test::measure(1'000'000, [&] {
+        test::keep(table);
+        test::keep(table.dispatch(&uart, 1));
+    });
+    test::keep(value);
+
+    test::report("function pointer call", raw_cost);
+    test::report("InplaceFunction, pointer", pointer_cost);
+    test::report("InplaceFunction, lambda", lambda_cost);
+    test::report("CallbackTable dispatch", dispatch_cost);
+}
+
+}  // namespace
+
+int main() {
+    test_function();
+    test_table();
+    bench_call();
+    return test::exit_code();
+}
@@ -0,0 +1,84 @@
+#include <ccl/irq_monitor.hpp>
+#include <cstdint>
+
+#include "check.hpp"
+
+using ccl::IrqMonitor;
+using ccl::IrqStats;
+
+namespace {
+
+struct SimClock {
+    static inline uint32_t now = 0;
+
+    static uint32_t cycles() {
+        return now;
+    }
+};
+
+constexpr std::size_t uart = 0;
+constexpr std::size_t dma = 1;
+constexpr std::size_t systick = 2;
+
+// A UART handler preempted by a DMA handler, which is itself preempted by
+// SysTick. Each handler is only charged for its own cycles.
+void test_nesting() {
+    IrqMonitor<4, SimClock, test::NoLock> monitor;
+
+    monitor.enter(uart, 12);
+    SimClock::now += 100;
+    monitor.enter(dma);
+    SimClock::now += 30;
+    monitor.enter(systick, 40);
+    SimClock::now += 20;
+    monitor.exit();
+    SimClock::now += 10;
+    monitor.exit();
+    SimClock::now += 50;
+    monitor.exit();
+
+    monitor.enter(uart, 15);
+    SimClock::now += 70;
+    monitor.exit();
+
+    const IrqStats uart_stats = monitor.take(uart);
+    CHECK(uart_stats.runs == 2);
+    CHECK(uart_stats.total_cycles == 100 + 50 + 70);
+    CHECK(uart_stats.max_cycles == 150);
+    CHECK(uart_stats.max_latency_cycles == 15);
+    CHECK(uart_stats.preempted == 1);
+
+    const IrqStats dma_stats = monitor.take(dma);
+    CHECK(dma_stats.runs == 1);
+    CHECK(dma_stats.total_cycles == 40);
+    CHECK(dma_stats.preempted == 1);
+    CHECK(dma_stats.max_latency_cycles == 0);
+
+    const IrqStats systick_stats = monitor.take(systick);
+    CHECK(systick_stats.total_cycles == 20);
+    CHECK(systick_stats.max_latency_cycles == 40);
+    CHECK(systick_stats.preempted == 0);
+
+    // 'take' resets.
+    CHECK(monitor.take(uart).runs == 0);
+    // An exit without an entry is ignored.
+    monitor.exit();
+    CHECK_PANICS(monitor.enter(4));
+}
+
+void test_wrap() {
+    IrqMonitor<1, SimClock, test::NoLock> monitor;
+    SimClock::now = UINT32_MAX - 5;
+    monitor.enter(0);
+    SimClock::now += 10;
+    monitor.exit();
+    CHECK(monitor.take(0).total_cycles == 10);
+}
+
+}  // namespace
+
+int main() {
+    test_nesting();
+    test_wrap();
+    return test::exit_code();
+}
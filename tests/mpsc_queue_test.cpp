@@ -0,0 +1,83 @@
+#include <array>
+#include <ccl/mpsc_queue.hpp>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+
+using ccl::MpscQueue;
+
+namespace {
+
+constexpr uint32_t producers = 4;
+constexpr uint32_t per_producer = 500'000;
+
+struct Message {
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+// Producers race for slots while the consumer drains. Every message must
+// arrive exactly once and in order per producer.
+void test_stress() {
+    static MpscQueue<Message, 32> queue;
+
+    std::vector<std::thread> threads;
+    for (uint32_t id = 0; id < producers; ++id) {
+        threads.emplace_back([id] {
+            for (uint32_t sequence = 0; sequence < per_producer;) {
+                if (queue.try_push(Message { id, sequence }).is_ok()) {
+                    ++sequence;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::array<uint32_t, producers> next {};
+    bool in_order = true;
+    uint32_t received = 0;
+    while (received < producers * per_producer) {
+        if (const auto message = queue.pop()) {
+            in_order &= message->producer < producers
+                        && message->sequence == next[message->producer];
+            ++next[message->producer % producers];
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(in_order);
+    CHECK(!queue.pop().has_value());
+    for (const uint32_t count : next) {
+        CHECK(count == per_producer);
+    }
+}
+
+void test_full() {
+    MpscQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.try_push(i).is_ok());
+    }
+    CHECK(queue.try_push(4).is_err());
+    CHECK(queue.pop() == std::optional<int> { 0 });
+    CHECK(queue.try_push(4).is_ok());
+    for (int i = 1; i < 5; ++i) {
+        CHECK(queue.pop() == std::optional<int> { i });
+    }
+    CHECK(!queue.pop().has_value());
+}
+
+}  // namespace
+
+int main() {
+    test_full();
+    test_stress();
+    return test::exit_code();
+}
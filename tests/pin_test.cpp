@@ -0,0 +1,35 @@
+// 'Pin' writes to fixed register addresses and only runs on the target.
+// Its constants and the board pin table are checked at compile time.
+
+#include "board_pins.hpp"
+
+#include "check.hpp"
+
+using obc::Pin;
+using obc::PinId;
+using obc::Port;
+using obc::board::is_labeled;
+
+namespace {
+
+using Button = Pin<Port::C, 13>;
+using UartTx = Pin<Port::A, 2>;
+using I2cScl = Pin<Port::B, 8>;
+
+static_assert(obc::board::Led::mask == GPIO_PIN_5);
+static_assert(obc::board::Led::id == PinId { Port::A, GPIO_PIN_5 });
+static_assert(Button::id != obc::board::Led::id);
+static_assert(Pin<Port::A, 13>::id != Button::id);
+
+static_assert(is_labeled(Button::id, "B1"));
+static_assert(is_labeled(UartTx::id, "USART_TX"));
+static_assert(is_labeled(I2cScl::id, "I2C_SCL"));
+static_assert(!is_labeled(I2cScl::id, "I2C_SDA"));
+static_assert(!is_labeled(UartTx::id, "NO_SUCH_LABEL"));
+static_assert(obc::board::labels_are_distinct());
+
+}  // namespace
+
+int main() {
+    return test::exit_code();
+}
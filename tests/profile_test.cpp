@@ -0,0 +1,120 @@
+#include <array>
+#include <ccl/byte_io.hpp>
+#include <ccl/profile.hpp>
+#include <cstdint>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::ByteReader;
+using ccl::ByteWriter;
+using ccl::ProfileStats;
+using ccl::ProfileTable;
+using ccl::ProfileZone;
+
+namespace {
+
+struct SimClock {
+    static inline uint32_t now = 0;
+
+    static uint32_t cycles() {
+        return now;
+    }
+};
+
+// Stands in for the DWT cycle counter, which is read with a single load.
+struct CounterClock {
+    static inline volatile uint32_t counter = 0;
+
+    static uint32_t cycles() {
+        return counter;
+    }
+};
+
+// A zone costs two counter reads and the update of its stats. The best of
+// several runs is compared, so other load on the host does not matter.
+constexpr double overhead_budget = 50;
+
+void test_overhead() {
+    static ProfileStats stats { "empty" };
+    constexpr uint32_t zones = 100'000;
+    const double overhead = test::measure(
+        zones, [] { const ProfileZone<CounterClock> zone { stats }; }, 20
+    );
+    test::report("ProfileZone overhead", overhead);
+    CHECK(overhead <= overhead_budget);
+    CHECK(stats.count() == 20 * zones);
+}
+
+void test_stats() {
+    ProfileStats stats { "filter" };
+    CHECK(stats.min_cycles() == UINT32_MAX);
+    for (const uint32_t cycles : { 0U, 1U, 2U, 3U, 1000U, 1U << 30 }) {
+        stats.add(cycles);
+    }
+    CHECK(stats.count() == 6);
+    CHECK(stats.min_cycles() == 0);
+    CHECK(stats.max_cycles() == 1U << 30);
+    CHECK(stats.total_cycles() == 1006 + (uint64_t { 1 } << 30));
+    CHECK(stats.histogram()[0] == 2);
+    CHECK(stats.histogram()[1] == 2);
+    CHECK(stats.histogram()[9] == 1);
+    CHECK(stats.histogram()[ProfileStats::buckets - 1] == 1);
+    stats.reset();
+    CHECK(stats.count() == 0);
+}
+
+void test_serialize() {
+    ProfileStats filter { "filter" };
+    ProfileStats send { "tx" };
+    ProfileTable<2, test::NoLock> table;
+    CHECK(table.try_add(filter).is_ok());
+    CHECK(table.try_add(send).is_ok());
+    CHECK(table.try_add(filter).is_err());
+
+    for (const uint32_t cycles : { 5U, 7U, 300U }) {
+        const ProfileZone<SimClock> zone { filter };
+        SimClock::now += cycles;
+    }
+
+    std::array<uint8_t, 256> frame {};
+    ByteWriter writer { frame };
+    CHECK(table.serialize(writer).is_ok());
+
+    ByteReader reader { writer.written() };
+    CHECK(reader.read<uint32_t>().unwrap() == 0x464F5250);  // "PROF"
+    CHECK(reader.read<uint16_t>().unwrap() == writer.position() - 6);
+    CHECK(reader.read<uint8_t>().unwrap() == 2);
+    CHECK(reader.read<uint8_t>().unwrap() == ProfileStats::buckets);
+
+    CHECK(reader.read<uint8_t>().unwrap() == 6);
+    CHECK(reader.skip(6).is_ok());
+    CHECK(reader.read<uint32_t>().unwrap() == 3);
+    CHECK(reader.read<uint32_t>().unwrap() == 5);
+    CHECK(reader.read<uint32_t>().unwrap() == 300);
+    CHECK(reader.read<uint64_t>().unwrap() == 312);
+    // 5 and 7 in bucket 2, 300 in bucket 8.
+    CHECK(reader.read<uint32_t>().unwrap() == ((1U << 2) | (1U << 8)));
+    CHECK(reader.read<uint32_t>().unwrap() == 2);
+    CHECK(reader.read<uint32_t>().unwrap() == 1);
+
+    CHECK(reader.read<uint8_t>().unwrap() == 2);
+    CHECK(reader.skip(2).is_ok());
+    CHECK(reader.read<uint32_t>().unwrap() == 0);
+    CHECK(reader.skip(4 + 4 + 8).is_ok());
+    CHECK(reader.read<uint32_t>().unwrap() == 0);
+    CHECK(reader.remaining() == 0);
+
+    std::array<uint8_t, 40> small {};
+    ByteWriter small_writer { small };
+    CHECK(table.serialize(small_writer).is_err());
+}
+
+}  // namespace
+
+int main() {
+    test_stats();
+    test_serialize();
+    test_overhead();
+    return test::exit_code();
+}
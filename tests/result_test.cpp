@@ -0,0 +1,222 @@
+#include <ccl/capacity_error.hpp>
+#include <ccl/result.hpp>
+#include <ccl/try.hpp>
+#include <cstdint>
+#include <optional>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using namespace ccl::prelude;
+using ccl::Err;
+using ccl::Ok;
+using ccl::Result;
+using ccl::Unit;
+
+namespace {
+
+enum class SensorError : uint8_t { Bus = 1, Timeout };
+
+}  // namespace
+
+template <>
+struct ccl::Niche<SensorError> {
+    static constexpr SensorError value = SensorError { 0 };
+};
+
+namespace {
+
+// Layout.
+static_assert(sizeof(Result<Unit, CapacityError>) == 1);
+static_assert(sizeof(Result<Unit, SensorError>) == 1);
+static_assert(sizeof(Result<SensorError, Unit>) == 1);
+static_assert(sizeof(Result<uint32_t, uint32_t>) == 8);
+
+// Constant evaluation.
+constexpr Result<uint32_t, SensorError> checked_baud(uint32_t baud) {
+    if (baud == 0 || baud > 1'000'000) {
+        return Err { SensorError::Bus };
+    }
+    return Ok { baud };
+}
+
+static_assert(checked_baud(115200).unwrap() == 115200);
+static_assert(checked_baud(0).is_err());
+static_assert(
+    checked_baud(9600).map([](uint32_t baud) { return baud * 2; }).unwrap()
+    == 19200
+);
+
+Result<uint8_t, SensorError> read_register(uint8_t reg) {
+    if (reg == 0) {
+        return Err { SensorError::Timeout };
+    }
+    return Ok { static_cast<uint8_t>(reg + 1) };
+}
+
+Result<uint16_t, SensorError> read_pair(uint8_t high, uint8_t low) {
+    const uint8_t h = CCL_TRY(read_register(high));
+    const uint8_t l = CCL_TRY(read_register(low));
+    return Ok { static_cast<uint16_t>(h << 8 | l) };
+}
+
+// What 'read_pair' replaces.
+Result<uint16_t, SensorError> read_pair_by_hand(uint8_t high, uint8_t low) {
+    const auto h = read_register(high);
+    if (h.is_err()) {
+        return Err { h.unwrap_err() };
+    }
+    const auto l = read_register(low);
+    if (l.is_err()) {
+        return Err { l.unwrap_err() };
+    }
+    return Ok { static_cast<uint16_t>(h.unwrap() << 8 | l.unwrap()) };
+}
+
+Result<uint16_t, int> read_pair_code(uint8_t high, uint8_t low) {
+    const uint16_t pair = CCL_TRY_MAP_ERR(read_pair(high, low), [](auto e) {
+        return static_cast<int>(e) * -1;
+    });
+    return Ok { pair };
+}
+
+void test_combinators() {
+    const Result<int, SensorError> ok = Ok { 2 };
+    const Result<int, SensorError> err = Err { SensorError::Bus };
+
+    CHECK(ok.map([](int v) { return v * 3; }).unwrap() == 6);
+    CHECK(
+        err.map([](int v) { return v * 3; }).unwrap_err() == SensorError::Bus
+    );
+    CHECK(err.map_err([](SensorError) { return 7; }).unwrap_err() == 7);
+    CHECK(
+        ok.and_then([](int v) -> Result<int, SensorError> {
+              return Err { v == 2 ? SensorError::Timeout : SensorError::Bus };
+          })
+            .unwrap_err()
+        == SensorError::Timeout
+    );
+    CHECK(
+        err.or_else([](SensorError) -> Result<int, SensorError> {
+               return Ok { 5 };
+           })
+            .unwrap()
+        == 5
+    );
+    CHECK(err.value_or(4) == 4);
+    CHECK(err.unwrap_or_else([](SensorError) { return 9; }) == 9);
+    CHECK(ok.ok() == std::optional<int> { 2 });
+    CHECK(!err.ok().has_value());
+    CHECK(err.err() == std::optional<SensorError> { SensorError::Bus });
+}
+
+void test_niche() {
+    const Result<Unit, SensorError> ok = Ok { Unit {} };
+    const Result<Unit, SensorError> err = Err { SensorError::Timeout };
+    CHECK(ok.is_ok());
+    CHECK(err.is_err());
+    CHECK(err.unwrap_err() == SensorError::Timeout);
+
+    const Result<SensorError, Unit> value = Ok { SensorError::Bus };
+    CHECK(value.is_ok());
+    CHECK(value.unwrap() == SensorError::Bus);
+
+    // The niche value cannot be stored.
+    CHECK_PANICS((Result<Unit, SensorError> { Err { SensorError { 0 } } }));
+    CHECK_PANICS((Result<SensorError, Unit> { Ok { SensorError { 0 } } }));
+}
+
+void test_try() {
+    CHECK(read_pair(1, 2).unwrap() == 0x0203);
+    CHECK(read_pair(0, 2).unwrap_err() == SensorError::Timeout);
+    CHECK(read_pair(1, 0).unwrap_err() == SensorError::Timeout);
+    CHECK(read_pair_code(1, 0).unwrap_err() == -2);
+    CHECK(read_pair_code(3, 4).unwrap() == 0x0405);
+    CHECK(read_pair_by_hand(1, 2).unwrap() == 0x0203);
+    CHECK(read_pair_by_hand(1, 0).unwrap_err() == SensorError::Timeout);
+}
+
+void test_panics() {
+    const Result<int, SensorError> err = Err { SensorError::Bus };
+    const Result<int, SensorError> ok = Ok { 1 };
+    CHECK_PANICS(err.unwrap());
+    CHECK_PANICS(err.expect("expected"));
+    CHECK_PANICS(ok.unwrap_err());
+}
+
+int scale_chained(const Result<int, SensorError>& reading) {
+    return reading.map([](int v) { return v * 2; })
+        .and_then([](int v) -> Result<int, SensorError> {
+            if (v > 100) {
+                return Err { SensorError::Bus };
+            }
+            return Ok { v + 1 };
+        })
+        .value_or(-1);
+}
+
+int scale_by_hand(const Result<int, SensorError>& reading) {
+    if (reading.is_err()) {
+        return -1;
+    }
+    const int doubled = reading.unwrap() * 2;
+    if (doubled > 100) {
+        return -1;
+    }
+    return doubled + 1;
+}
+
+// A chain of combinators against the branches it replaces. Both are
+// inlined, so equal costs mean equal code.
+void bench_combinators() {
+    for (const int value : { 7, 70 }) {
+        CHECK(scale_chained(Ok { value }) == scale_by_hand(Ok { value }));
+    }
+    CHECK(scale_chained(Err { SensorError::Bus }) == -1);
+
+    Result<int, SensorError> reading = Ok { 7 };
+    int sum = 0;
+    const double chained_cost = test::measure(1'000'000, [&] {
+        test::keep(reading);
+        sum += scale_chained(reading);
+    });
+    const double by_hand_cost = test::measure(1'000'000, [&] {
+        test::keep(reading);
+        sum += scale_by_hand(reading);
+    });
+    test::keep(sum);
+
+    test::report("Result combinator chain", chained_cost);
+    test::report("Result branches by hand", by_hand_cost);
+}
+
+// 'CCL_TRY' against the checks it replaces.
+void bench_try() {
+    uint8_t high = 1;
+    uint8_t low = 2;
+    uint32_t sum = 0;
+    const double try_cost = test::measure(1'000'000, [&] {
+        test::keep(high);
+        sum += read_pair(high, low).unwrap();
+    });
+    const double by_hand_cost = test::measure(1'000'000, [&] {
+        test::keep(high);
+        sum += read_pair_by_hand(high, low).unwrap();
+    });
+    test::keep(sum);
+
+    test::report("CCL_TRY", try_cost);
+    test::report("Result checks by hand", by_hand_cost);
+}
+
+}  // namespace
+
+int main() {
+    test_combinators();
+    test_niche();
+    test_try();
+    test_panics();
+    bench_combinators();
+    bench_try();
+    return test::exit_code();
+}
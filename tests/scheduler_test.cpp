@@ -0,0 +1,125 @@
+#include <ccl/scheduler.hpp>
+#include <cstdint>
+#include <iterator>
+
+#include "check.hpp"
+
+using ccl::Scheduler;
+using ccl::Task;
+
+namespace {
+
+// Simulated time, tasks advance it by the ticks they take.
+struct SimClock {
+    static inline uint32_t ticks = 0;
+
+    static uint32_t now() {
+        return ticks;
+    }
+
+    static uint32_t cycles() {
+        return ticks * 100;
+    }
+
+    static void idle_until(uint32_t deadline) {
+        ticks = deadline;
+    }
+};
+
+uint32_t sensor_runs = 0;
+uint32_t report_runs = 0;
+uint32_t input_runs = 0;
+uint32_t slow_runs = 0;
+uint32_t pending_input = 0;
+uint32_t last_sensor_start = 0;
+bool sensor_too_late = false;
+
+void sample_sensor() {
+    // Must run within a tick of its release, everything else is longer.
+    if (sensor_runs > 0 && SimClock::ticks - last_sensor_start > 10 + 2) {
+        sensor_too_late = true;
+    }
+    last_sensor_start = SimClock::ticks;
+    ++sensor_runs;
+    SimClock::ticks += 1;
+}
+
+void send_report() {
+    ++report_runs;
+    SimClock::ticks += 2;
+}
+
+void handle_input() {
+    ++input_runs;
+    if (pending_input > 0) {
+        --pending_input;
+    }
+}
+
+bool has_input() {
+    return pending_input > 0;
+}
+
+void overrun() {
+    ++slow_runs;
+    SimClock::ticks += 25;
+}
+
+void test_priorities_and_periods() {
+    constexpr Task tasks[] = {
+        { "report", send_report, 50, 5, 1 },
+        { "sensor", sample_sensor, 10, 0, 0 },
+        { "input", handle_input, 100, 0, 2, has_input },
+    };
+    static_assert(ccl::is_valid_schedule(tasks));
+
+    SimClock::ticks = 0;
+    Scheduler<SimClock, std::size(tasks)> scheduler { tasks };
+    bool input_queued = false;
+    while (SimClock::ticks < 1000) {
+        if (!input_queued && SimClock::ticks >= 333) {
+            // Queued by an interrupt, between two periodic runs.
+            pending_input = 3;
+            input_queued = true;
+        }
+        if (!scheduler.run_once()) {
+            SimClock::idle_until(scheduler.next_release());
+        }
+    }
+
+    CHECK(scheduler.stats(0).runs == 20);
+    CHECK(scheduler.stats(1).runs == 100);
+    CHECK(!sensor_too_late);
+    CHECK(scheduler.stats(0).deadline_misses == 0);
+    CHECK(scheduler.stats(1).deadline_misses == 0);
+    // 10 periodic runs and one per queued input.
+    CHECK(input_runs == 13);
+    CHECK(scheduler.stats(2).deadline_misses == 0);
+    CHECK(scheduler.stats(0).max_cycles == 200);
+}
+
+void test_deadline_misses() {
+    constexpr Task tasks[] = {
+        { "slow", overrun, 10, 0, 0 },
+    };
+
+    SimClock::ticks = 0;
+    Scheduler<SimClock, std::size(tasks)> scheduler { tasks };
+    while (SimClock::ticks < 100) {
+        if (!scheduler.run_once()) {
+            SimClock::idle_until(scheduler.next_release());
+        }
+    }
+    // Each run takes 25 ticks and misses its own deadline. The releases
+    // that passed meanwhile are skipped, one or two each time.
+    CHECK(slow_runs == 4);
+    CHECK(scheduler.stats(0).deadline_misses == 4 + 4);
+}
+
+}  // namespace
+
+int main() {
+    test_priorities_and_periods();
+    test_deadline_misses();
+    return test::exit_code();
+}
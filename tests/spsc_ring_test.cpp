@@ -0,0 +1,177 @@
+#include <array>
+#include <ccl/spsc_ring.hpp>
+#include <cstdint>
+#include <thread>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::SpscRing;
+
+namespace {
+
+constexpr uint32_t count = 2'000'000;
+
+// The producer and consumer threads each use all three access styles in
+// turn, so every combination of single elements, copies and in-place
+// regions runs against each other, across the wrap of the storage.
+void test_stress() {
+    static SpscRing<uint32_t, 64> ring;
+
+    std::thread producer { [] {
+        uint32_t next = 0;
+        std::array<uint32_t, 7> chunk {};
+        while (next < count) {
+            const uint32_t before = next;
+            switch (next % 3) {
+                case 0:
+                    if (ring.try_push(next).is_ok()) {
+                        ++next;
+                    }
+                    break;
+                case 1: {
+                    const uint32_t size =
+                        count - next < chunk.size() ? count - next : 7;
+                    for (uint32_t i = 0; i < size; ++i) {
+                        chunk[i] = next + i;
+                    }
+                    if (ring.try_write(chunk.data(), size).is_ok()) {
+                        next += size;
+                    }
+                    break;
+                }
+                default: {
+                    auto region = ring.write_region();
+                    std::size_t size = region.size;
+                    if (size > count - next) {
+                        size = count - next;
+                    }
+                    for (std::size_t i = 0; i < size; ++i) {
+                        region.data[i] = next + i;
+                    }
+                    ring.commit(size);
+                    next += size;
+                    break;
+                }
+            }
+            // The test may run on a single core.
+            if (next == before) {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    uint32_t expected = 0;
+    bool in_order = true;
+    std::array<uint32_t, 5> chunk {};
+    while (expected < count) {
+        const uint32_t before = expected;
+        switch (expected % 3) {
+            case 0:
+                if (const auto value = ring.pop()) {
+                    in_order &= *value == expected;
+                    ++expected;
+                }
+                break;
+            case 1: {
+                const std::size_t size = ring.read(chunk.data(), chunk.size());
+                for (std::size_t i = 0; i < size; ++i) {
+                    in_order &= chunk[i] == expected;
+                    ++expected;
+                }
+                break;
+            }
+            default: {
+                const auto region = ring.read_region();
+                for (std::size_t i = 0; i < region.size; ++i) {
+                    in_order &= region.data[i] == expected + i;
+                }
+                ring.release(region.size);
+                expected += region.size;
+                break;
+            }
+        }
+        if (expected == before) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    CHECK(in_order);
+    CHECK(expected == count);
+    CHECK(ring.empty());
+}
+
+void test_regions() {
+    SpscRing<uint8_t, 8> ring;
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5, 6 };
+    CHECK(ring.try_write(bytes, 6).is_ok());
+    CHECK(ring.try_write(bytes, 3).is_err());
+    std::array<uint8_t, 4> out {};
+    CHECK(ring.read(out.data(), 4) == 4);
+
+    // Free space: 2 at the end of the storage, 4 after the wrap.
+    const auto first = ring.write_region();
+    CHECK(first.size == 2);
+    const auto second = ring.write_region(first.size);
+    CHECK(second.size == 4);
+    CHECK(ring.write_region(6).size == 0);
+
+    CHECK(ring.try_write(bytes, 6).is_ok());
+    CHECK(ring.size() == 8);
+    const auto filled = ring.read_region();
+    CHECK(filled.size == 4);
+    CHECK(filled.data[0] == 5);
+    CHECK(ring.read_region(filled.size).size == 4);
+}
+
+// Cost per element of one thread pushing and popping, and of copies of 16
+// elements between two threads. On a single core the latter includes the
+// switches between the threads.
+void bench_throughput() {
+    static SpscRing<uint32_t, 256> ring;
+
+    uint32_t value = 0;
+    const double single = test::measure(1'000'000, [&value] {
+        static_cast<void>(ring.try_push(value++));
+        test::keep(ring.pop());
+    });
+    test::report("SpscRing push + pop", single);
+
+    constexpr uint32_t elements = 8'000'000;
+    constexpr std::size_t chunk_size = 16;
+    const uint64_t start = test::BenchClock::now();
+    std::thread producer { [] {
+        std::array<uint32_t, chunk_size> chunk {};
+        for (uint32_t next = 0; next < elements;) {
+            if (ring.try_write(chunk.data(), chunk.size()).is_ok()) {
+                next += chunk_size;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    } };
+    std::array<uint32_t, chunk_size> chunk {};
+    for (uint32_t received = 0; received < elements;) {
+        const std::size_t size = ring.read(chunk.data(), chunk.size());
+        if (size == 0) {
+            std::this_thread::yield();
+        }
+        received += size;
+    }
+    producer.join();
+    const uint64_t elapsed = test::BenchClock::now() - start;
+    test::report(
+        "SpscRing threaded per element",
+        static_cast<double>(elapsed) / elements
+    );
+}
+
+}  // namespace
+
+int main() {
+    test_regions();
+    test_stress();
+    bench_throughput();
+    return test::exit_code();
+}
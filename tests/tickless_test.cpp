@@ -0,0 +1,67 @@
+#include <ccl/tickless.hpp>
+#include <cstdint>
+
+#include "check.hpp"
+
+using ccl::IdleDecision;
+using ccl::IdleMode;
+using ccl::IdlePolicy;
+using ccl::plan_idle;
+using ccl::TickCompensator;
+
+namespace {
+
+constexpr IdlePolicy policy { 5, 1900, 1 };
+
+static_assert(plan_idle(0, true, policy).mode == IdleMode::Run);
+static_assert(plan_idle(5, true, policy).mode == IdleMode::Sleep);
+static_assert(plan_idle(6, true, policy).mode == IdleMode::Stop);
+static_assert(plan_idle(6, true, policy).ticks == 5);
+static_assert(plan_idle(100, false, policy).mode == IdleMode::Sleep);
+static_assert(plan_idle(5000, true, policy).ticks == 1900);
+
+// Stops of random lengths, each starting part way into a tick, at
+// 32768 Hz and 1 kHz. The ticks counted must always equal the elapsed time
+// rounded down, however many stops there are, and each stop must last just
+// long enough. Fractions of a tick are resolved to 1/32768 of a tick.
+void test_no_drift() {
+    constexpr uint32_t counter_hz = 32768;
+    constexpr uint32_t tick_hz = 1000;
+    constexpr uint32_t systick_period = 80'000;
+    TickCompensator compensator { counter_hz, tick_hz };
+
+    // In 1/counter_hz ticks.
+    uint64_t elapsed = 0;
+    uint64_t ticks = 0;
+    bool exact = true;
+    bool wakes_in_time = true;
+    uint32_t state = 3;
+    for (int stop = 0; stop < 100'000; ++stop) {
+        state = state * 1664525 + 1013904223;
+        const uint32_t systick_elapsed = (state >> 8) % systick_period;
+        const uint32_t wanted = 1 + (state >> 4) % 1900;
+
+        compensator.add_fraction(systick_elapsed, systick_period);
+        elapsed += uint64_t { systick_elapsed } * counter_hz / systick_period;
+
+        const uint32_t counts = compensator.counts_for(wanted);
+        TickCompensator early = compensator;
+        wakes_in_time &=
+            counts == 1 || early.elapsed_ticks(counts - 1) < wanted;
+        const uint32_t counted = compensator.elapsed_ticks(counts);
+        wakes_in_time &= counted >= wanted;
+
+        ticks += counted;
+        elapsed += uint64_t { counts } * tick_hz;
+        exact &= ticks == elapsed / counter_hz;
+    }
+    CHECK(exact);
+    CHECK(wakes_in_time);
+}
+
+}  // namespace
+
+int main() {
+    test_no_drift();
+    return test::exit_code();
+}
@@ -0,0 +1,203 @@
+#include <array>
+#include <ccl/timer_wheel.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::Timer;
+using ccl::TimerWheel;
+
+namespace {
+
+using Wheel = TimerWheel<test::NoLock>;
+
+// What each timer should do, kept next to the wheel and compared on every
+// expiry.
+struct Expected {
+    bool active;
+    uint32_t expiry;
+    uint32_t period;
+    uint32_t fired;
+};
+
+constexpr std::size_t timer_count = 48;
+
+Wheel wheel;
+std::deque<Timer> timers;
+std::array<Expected, timer_count> expected {};
+bool on_time = true;
+
+void start(std::size_t index, uint32_t delay, uint32_t period) {
+    wheel.start(timers[index], delay, period);
+    expected[index] =
+        Expected { true, wheel.now() + (delay > 0 ? delay : 1), period,
+                   expected[index].fired };
+}
+
+void on_expiry(std::size_t index) {
+    Expected& timer = expected[index];
+    on_time &= timer.active && timer.expiry == wheel.now();
+    ++timer.fired;
+    if (timer.period != 0) {
+        timer.expiry += timer.period;
+    } else {
+        timer.active = false;
+        // Some one-shot timers restart themselves from their callback.
+        if (index % 8 == 0) {
+            start(index, 3, 0);
+        }
+    }
+}
+
+// Random starts, restarts and cancels of interrupt and deferred timers
+// with delays reaching into the third level, checked against the expected
+// expiry of each timer.
+void test_simulation() {
+    for (std::size_t i = 0; i < timer_count; ++i) {
+        timers.emplace_back(
+            [i] { on_expiry(i); },
+            i % 2 == 0 ? Timer::Dispatch::Interrupt : Timer::Dispatch::Deferred
+        );
+    }
+
+    uint32_t state = 1;
+    const auto random = [&state](uint32_t bound) {
+        state = state * 1664525 + 1013904223;
+        return (state >> 8) % bound;
+    };
+
+    bool never_late = true;
+    bool none_missed = true;
+    for (uint32_t step = 0; step < 400'000; ++step) {
+        const uint32_t action = random(100);
+        const std::size_t index = random(timer_count);
+        if (action < 4) {
+            const uint32_t range = random(3) == 0 ? 300'000 : 100;
+            start(index, random(range), random(2) == 0 ? random(300) : 0);
+        } else if (action < 6) {
+            wheel.cancel(timers[index]);
+            expected[index].active = false;
+        }
+
+        uint32_t next = UINT32_MAX;
+        for (const Expected& timer : expected) {
+            if (timer.active && timer.expiry - wheel.now() < next) {
+                next = timer.expiry - wheel.now();
+            }
+        }
+        never_late &= wheel.ticks_until_next(1U << 20) <= next;
+
+        wheel.tick();
+        wheel.run_deferred();
+        for (const Expected& timer : expected) {
+            none_missed &=
+                !timer.active
+                || static_cast<int32_t>(timer.expiry - wheel.now()) > 0;
+        }
+    }
+
+    uint32_t fired = 0;
+    for (std::size_t i = 0; i < timer_count; ++i) {
+        fired += expected[i].fired;
+        CHECK(timers[i].is_active() == expected[i].active);
+    }
+    CHECK(on_time);
+    CHECK(none_missed);
+    CHECK(never_late);
+    CHECK(fired > 10'000);
+}
+
+// Delays beyond the range of the wheel are moved down again.
+void test_long_delay() {
+    TimerWheel<test::NoLock> long_wheel;
+    uint32_t fired_at = 0;
+    Timer timer { [&fired_at, &long_wheel] { fired_at = long_wheel.now(); },
+                  Timer::Dispatch::Interrupt };
+    constexpr uint32_t delay = (1U << 24) + 1000;
+    long_wheel.start(timer, delay);
+    while (fired_at == 0 && long_wheel.now() < delay + 10) {
+        long_wheel.tick();
+    }
+    CHECK(fired_at == delay);
+    CHECK(!timer.is_active());
+}
+
+void test_deferred_order() {
+    TimerWheel<test::NoLock> order_wheel;
+    std::array<int, 3> order {};
+    std::size_t runs = 0;
+    Timer first { [&] { order[runs++] = 1; } };
+    Timer second { [&] { order[runs++] = 2; } };
+    Timer third { [&] { order[runs++] = 3; } };
+    order_wheel.start(third, 3);
+    order_wheel.start(second, 2);
+    order_wheel.start(first, 1);
+    for (int i = 0; i < 3; ++i) {
+        order_wheel.tick();
+    }
+    CHECK(order_wheel.has_deferred());
+    CHECK(order_wheel.run_deferred() == 3);
+    CHECK(!order_wheel.has_deferred());
+    CHECK(order == (std::array<int, 3> { 1, 2, 3 }));
+
+    order_wheel.start(first, 1);
+    order_wheel.tick();
+    order_wheel.cancel(first);
+    CHECK(order_wheel.run_deferred() == 0);
+}
+
+// Cost of a tick with 4000 periodic timers of periods up to 5 seconds at
+// a 1 ms tick, and of starting and cancelling one of them. The longest
+// ticks are the ones moving timers down from the higher levels.
+void bench_ticks() {
+    static TimerWheel<test::NoLock> bench_wheel;
+    static std::deque<Timer> bench_timers;
+    constexpr std::size_t count = 4000;
+    uint32_t fired = 0;
+
+    uint32_t state = 3;
+    for (std::size_t i = 0; i < count; ++i) {
+        state = state * 1664525 + 1013904223;
+        const uint32_t period = 1 + (state >> 8) % 5000;
+        bench_timers.emplace_back(
+            [&fired] { ++fired; }, Timer::Dispatch::Interrupt
+        );
+        bench_wheel.start(bench_timers.back(), period, period);
+    }
+
+    constexpr uint32_t ticks = 200'000;
+    test::Samples tick_timing;
+    for (uint32_t i = 0; i < ticks; ++i) {
+        const uint64_t start = test::BenchClock::now();
+        bench_wheel.tick();
+        tick_timing.add(start);
+    }
+    CHECK(fired > ticks);
+
+    std::size_t index = 0;
+    const double restart_cost = test::measure(100'000, [&index] {
+        Timer& timer = bench_timers[index];
+        index = (index + 1) % count;
+        bench_wheel.cancel(timer);
+        bench_wheel.start(timer, 1 + index, 1 + index);
+    });
+
+    tick_timing.report("TimerWheel tick");
+    test::report("TimerWheel cancel + start", restart_cost);
+    for (Timer& timer : bench_timers) {
+        bench_wheel.cancel(timer);
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_deferred_order();
+    test_simulation();
+    test_long_delay();
+    bench_ticks();
+    return test::exit_code();
+}
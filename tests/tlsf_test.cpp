@@ -0,0 +1,153 @@
+#include <ccl/tlsf.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "bench.hpp"
+#include "check.hpp"
+
+using ccl::Tlsf;
+
+namespace {
+
+struct Allocation {
+    unsigned char* data;
+    std::size_t size;
+    unsigned char fill;
+};
+
+bool is_filled(const Allocation& allocation) {
+    for (std::size_t i = 0; i < allocation.size; ++i) {
+        if (allocation.data[i] != allocation.fill) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random allocations and frees of mixed sizes and alignments. Every block
+// is filled with its own byte, so overlapping blocks or headers written
+// into payloads show up as changed contents. Each call is timed for the
+// worst case.
+void test_stress() {
+    alignas(8) static unsigned char region[64 * 1024];
+    Tlsf heap { region, sizeof(region) };
+    const std::size_t initial_free = heap.stats().free;
+
+    std::vector<Allocation> live;
+    uint32_t state = 7;
+    const auto random = [&state](uint32_t bound) {
+        state = state * 1664525 + 1013904223;
+        return (state >> 8) % bound;
+    };
+
+    bool intact = true;
+    bool aligned = true;
+    bool usable = true;
+    std::size_t failures = 0;
+    test::Samples allocate_timing;
+    test::Samples free_timing;
+    for (uint32_t round = 0; round < 200'000; ++round) {
+        if (live.empty() || random(100) < 55) {
+            const std::size_t size =
+                random(8) == 0 ? 1 + random(4096) : 1 + random(96);
+            const std::size_t alignment = std::size_t { 8 } << random(4);
+            const uint64_t start = test::BenchClock::now();
+            auto result = heap.try_allocate(size, alignment);
+            allocate_timing.add(start);
+            if (result.is_err()) {
+                ++failures;
+                continue;
+            }
+            auto* data = static_cast<unsigned char*>(result.unwrap());
+            aligned &= reinterpret_cast<std::uintptr_t>(data) % alignment == 0;
+            usable &= Tlsf::usable_size(data) >= size;
+            const auto fill = static_cast<unsigned char>(round);
+            std::memset(data, fill, size);
+            live.push_back(Allocation { data, size, fill });
+        } else {
+            const std::size_t index = random(live.size());
+            intact &= is_filled(live[index]);
+            const uint64_t start = test::BenchClock::now();
+            heap.free(live[index].data);
+            free_timing.add(start);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+    for (const Allocation& allocation : live) {
+        intact &= is_filled(allocation);
+        heap.free(allocation.data);
+    }
+
+    CHECK(intact);
+    CHECK(aligned);
+    CHECK(usable);
+    CHECK(failures > 0);
+    allocate_timing.report("Tlsf try_allocate");
+    free_timing.report("Tlsf free");
+
+    // Everything merged back into one block.
+    const Tlsf::Stats stats = heap.stats();
+    CHECK(stats.used == 0);
+    CHECK(stats.peak > 0);
+    CHECK(stats.free == initial_free);
+    CHECK(stats.free_blocks == 1);
+    CHECK(stats.largest_free == stats.free);
+}
+
+void test_stats() {
+    alignas(8) static unsigned char region[4096];
+    Tlsf heap { region, sizeof(region) };
+
+    void* a = heap.try_allocate(100).unwrap();
+    void* b = heap.try_allocate(200).unwrap();
+    void* c = heap.try_allocate(100).unwrap();
+    Tlsf::Stats stats = heap.stats();
+    CHECK(stats.used == Tlsf::usable_size(a) + Tlsf::usable_size(b)
+                            + Tlsf::usable_size(c));
+    CHECK(stats.free_blocks == 1);
+
+    // A hole between two used blocks is free but not the largest block.
+    heap.free(b);
+    stats = heap.stats();
+    CHECK(stats.free_blocks == 2);
+    CHECK(stats.largest_free < stats.free);
+    CHECK(heap.try_allocate(stats.largest_free - stats.largest_free / 8)
+              .is_ok());
+    CHECK(heap.try_allocate(stats.free).is_err());
+
+    heap.free(nullptr);
+    heap.free(a);
+    heap.free(c);
+}
+
+// Requests no block can hold fail without wrapping the size computations.
+void test_oversized() {
+    alignas(8) static unsigned char region[4096];
+    Tlsf heap { region, sizeof(region) };
+    constexpr std::size_t alignment_max = ~(SIZE_MAX >> 1);
+
+    CHECK(heap.try_allocate(Tlsf::block_size_max + 1).is_err());
+    CHECK(heap.try_allocate(SIZE_MAX).is_err());
+    CHECK(heap.try_allocate(1, Tlsf::block_size_max).is_err());
+    CHECK(heap.try_allocate(1, Tlsf::block_size_max << 1).is_err());
+    CHECK(heap.try_allocate(1, alignment_max).is_err());
+    CHECK(heap.try_allocate(SIZE_MAX, alignment_max).is_err());
+
+    const Tlsf::Stats stats = heap.stats();
+    CHECK(stats.used == 0);
+    CHECK(stats.free_blocks == 1);
+    void* p = heap.try_allocate(100, 64).unwrap();
+    heap.free(p);
+}
+
+}  // namespace
+
+int main() {
+    test_stats();
+    test_oversized();
+    test_stress();
+    return test::exit_code();
+}
@@ -0,0 +1,153 @@
+#include "uart_rx.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "check.hpp"
+
+using obc::UartRx;
+
+namespace {
+
+// Simulated circular DMA reception, writes into the buffer passed to
+// 'HAL_UARTEx_ReceiveToIdle_DMA' and raises the events the HAL raises.
+struct SimDma {
+    uint8_t* buffer = nullptr;
+    uint16_t size = 0;
+    uint16_t position = 0;
+    int starts = 0;
+};
+
+SimDma dma;
+
+// Receivers stay bound to their UART, so each test has its own.
+UART_HandleTypeDef huart1 {};
+UartRx rx1 { &huart1 };
+UART_HandleTypeDef huart2 {};
+UartRx rx2 { &huart2 };
+
+// A burst of bytes followed by an idle line. Raises half transfer and
+// transfer complete events on the way.
+void receive(UART_HandleTypeDef* huart, const std::vector<uint8_t>& bytes) {
+    bool reported = true;
+    for (const uint8_t byte : bytes) {
+        dma.buffer[dma.position++] = byte;
+        reported = false;
+        if (dma.position == dma.size / 2) {
+            HAL_UARTEx_RxEventCallback(huart, dma.position);
+            reported = true;
+        } else if (dma.position == dma.size) {
+            HAL_UARTEx_RxEventCallback(huart, dma.position);
+            dma.position = 0;
+            reported = true;
+        }
+    }
+    if (!reported) {
+        HAL_UARTEx_RxEventCallback(huart, dma.position);
+    }
+}
+
+std::vector<uint8_t> sequence(uint8_t& next, std::size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes) {
+        byte = next++;
+    }
+    return bytes;
+}
+
+std::vector<uint8_t> drain(UartRx& rx) {
+    std::vector<uint8_t> bytes;
+    rx.drain([&bytes](const uint8_t* data, std::size_t size) {
+        bytes.insert(bytes.end(), data, data + size);
+    });
+    return bytes;
+}
+
+void test_stream() {
+    UART_HandleTypeDef& huart = huart1;
+    UartRx& rx = rx1;
+    CHECK(rx.start().is_ok());
+    CHECK(rx.start().unwrap_err() == HAL_BUSY);
+    CHECK(dma.size == UartRx::capacity);
+
+    uint8_t sent = 0;
+    uint8_t expected = 0;
+    bool in_order = true;
+    uint32_t total = 0;
+    uint32_t state = 5;
+    for (int burst = 0; burst < 5000; ++burst) {
+        state = state * 1664525 + 1013904223;
+        const std::size_t size = 1 + (state >> 8) % 200;
+        receive(&huart, sequence(sent, size));
+        total += size;
+        // Drain before the DMA catches up with the unread bytes.
+        if (rx.available() > UartRx::capacity - 200 || (state >> 4) % 2 == 0) {
+            for (const uint8_t byte : drain(rx)) {
+                in_order &= byte == expected++;
+            }
+        }
+    }
+    for (const uint8_t byte : drain(rx)) {
+        in_order &= byte == expected++;
+    }
+    CHECK(in_order);
+    CHECK(rx.available() == 0);
+    CHECK(rx.stats().received == total);
+    CHECK(rx.stats().dropped == 0);
+}
+
+void test_overrun_and_restart() {
+    UART_HandleTypeDef& huart = huart2;
+    UartRx& rx = rx2;
+    CHECK(rx.start().is_ok());
+
+    // The DMA overwrites unread data, the receiver drops it all.
+    uint8_t sent = 0;
+    receive(&huart, sequence(sent, UartRx::capacity + 10));
+    CHECK(drain(rx).empty());
+    CHECK(rx.stats().dropped == UartRx::capacity + 10);
+
+    // An overrun aborts the reception, the bytes not yet read are dropped
+    // and the reception starts over at the start of the buffer.
+    receive(&huart, sequence(sent, 20));
+    const int starts = dma.starts;
+    huart.RxState = HAL_UART_STATE_READY;
+    HAL_UART_ErrorCallback(&huart);
+    CHECK(dma.starts == starts + 1);
+    CHECK(rx.stats().errors == 1);
+
+    uint8_t after = 100;
+    receive(&huart, sequence(after, 30));
+    const std::vector<uint8_t> bytes = drain(rx);
+    CHECK(bytes.size() == 30);
+    CHECK(!bytes.empty() && bytes.front() == 100);
+    CHECK(rx.stats().dropped == UartRx::capacity + 10 + 20);
+    CHECK(rx.stats().received == UartRx::capacity + 10 + 20 + 30);
+
+    // Noise does not abort the reception.
+    huart.RxState = HAL_UART_STATE_BUSY_RX;
+    HAL_UART_ErrorCallback(&huart);
+    CHECK(dma.starts == starts + 1);
+    CHECK(rx.stats().errors == 2);
+}
+
+}  // namespace
+
+extern "C" HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(
+    UART_HandleTypeDef* huart,
+    uint8_t* data,
+    uint16_t size
+) {
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    dma.buffer = data;
+    dma.size = size;
+    dma.position = 0;
+    ++dma.starts;
+    return HAL_OK;
+}
+
+int main() {
+    test_stream();
+    test_overrun_and_restart();
+    return test::exit_code();
+}